@@ -5,6 +5,7 @@
  */
 
 #include "dolphinbookmarkhandler.h"
+#include "dolphinlocationindex.h"
 #include "dolphinmainwindow.h"
 #include "dolphinviewcontainer.h"
 #include "global.h"
@@ -34,10 +35,26 @@ DolphinBookmarkHandler::DolphinBookmarkHandler(DolphinMainWindow *mainWindow, KA
     collection->addAction(QStringLiteral("add_bookmark"), m_bookmarkMenu->addBookmarkAction());
     collection->addAction(QStringLiteral("edit_bookmarks"), m_bookmarkMenu->editBookmarksAction());
     collection->addAction(QStringLiteral("add_bookmarks_list"), m_bookmarkMenu->bookmarkTabsAsFolderAction());
+
+    addBookmarksToLocationIndex(m_bookmarkManager->root());
+    connect(m_bookmarkManager.get(), &KBookmarkManager::changed, this, [this]() {
+        addBookmarksToLocationIndex(m_bookmarkManager->root());
+    });
 }
 
 DolphinBookmarkHandler::~DolphinBookmarkHandler() = default;
 
+void DolphinBookmarkHandler::addBookmarksToLocationIndex(const KBookmarkGroup &group)
+{
+    for (KBookmark bookmark = group.first(); !bookmark.isNull(); bookmark = group.next(bookmark)) {
+        if (bookmark.isGroup()) {
+            addBookmarksToLocationIndex(bookmark.toGroup());
+        } else if (!bookmark.isSeparator()) {
+            DolphinLocationIndex::instance().addLocation(bookmark.url(), DolphinLocationIndex::Bookmark);
+        }
+    }
+}
+
 QString DolphinBookmarkHandler::currentTitle() const
 {
     return title(m_mainWindow->activeViewContainer());
@@ -39,6 +39,11 @@ private:
     static QUrl url(DolphinViewContainer *viewContainer);
     static QString icon(DolphinViewContainer *viewContainer);
 
+    /**
+     * Adds the bookmarks of \a group and its subgroups to the DolphinLocationIndex.
+     */
+    static void addBookmarksToLocationIndex(const KBookmarkGroup &group);
+
 private:
     DolphinMainWindow *m_mainWindow;
     std::unique_ptr<KBookmarkManager> m_bookmarkManager;
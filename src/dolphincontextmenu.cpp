@@ -12,6 +12,7 @@
 #include "dolphinnewfilemenu.h"
 #include "dolphinplacesmodelsingleton.h"
 #include "dolphinremoveaction.h"
+#include "dolphinservicemenucache.h"
 #include "dolphinviewcontainer.h"
 #include "global.h"
 #include "search/dolphinquery.h"
@@ -40,18 +41,21 @@ DolphinContextMenu::DolphinContextMenu(DolphinMainWindow *parent,
                                        const KFileItem &fileInfo,
                                        const KFileItemList &selectedItems,
                                        const QUrl &baseUrl,
-                                       KFileItemActions *fileItemActions)
+                                       KFileItemActions *fileItemActions,
+                                       DolphinServiceMenuCache *serviceMenuCache,
+                                       const KFileItemListProperties *selectedItemsProperties)
     : QMenu(parent)
     , m_mainWindow(parent)
     , m_fileInfo(fileInfo)
     , m_baseUrl(baseUrl)
     , m_baseFileItem(nullptr)
     , m_selectedItems(selectedItems)
-    , m_selectedItemsProperties(nullptr)
+    , m_selectedItemsProperties(selectedItemsProperties ? new KFileItemListProperties(*selectedItemsProperties) : nullptr)
     , m_context(NoContext)
     , m_copyToMenu(parent)
     , m_removeAction(nullptr)
     , m_fileItemActions(fileItemActions)
+    , m_serviceMenuCache(serviceMenuCache)
 {
     QApplication::instance()->installEventFilter(this);
 
@@ -542,7 +546,9 @@ void DolphinContextMenu::addAdditionalActions(const KFileItemListProperties &pro
     if (props.isLocal() && props.isDirectory() && ContextMenuSettings::showOpenTerminal()) {
         additionalActions << m_mainWindow->actionCollection()->action(QStringLiteral("open_terminal_here"));
     }
-    m_fileItemActions->addActionsTo(this, KFileItemActions::MenuActionSource::All, additionalActions);
+    m_serviceMenuCache->addActionsTo(this, props);
+    // The actions of the plugins are bound to the items, so they cannot be cached
+    m_fileItemActions->addActionsTo(this, KFileItemActions::MenuActionSource::Plugins, additionalActions);
 
     const DolphinView *view = m_mainWindow->activeViewContainer()->view();
     const QList<QAction *> versionControlActions = view->versionControlActions(m_selectedItems);
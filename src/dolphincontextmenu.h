@@ -18,6 +18,7 @@ class QAction;
 class DolphinMainWindow;
 class KFileItemListProperties;
 class DolphinRemoveAction;
+class DolphinServiceMenuCache;
 
 /**
  * @brief Represents the context menu which appears when doing a right
@@ -46,12 +47,17 @@ public:
      *                is opened. This list generally includes \a fileInfo.
      * @baseUrl       Base URL of the viewport where the context menu
      *                should be opened.
+     * @serviceMenuCache Cache that provides the service menu actions.
+     * @selectedItemsProperties Properties of \a selectedItems if they are
+     *                already known. Otherwise they get computed.
      */
     DolphinContextMenu(DolphinMainWindow *parent,
                        const KFileItem &fileInfo,
                        const KFileItemList &selectedItems,
                        const QUrl &baseUrl,
-                       KFileItemActions *fileItemActions);
+                       KFileItemActions *fileItemActions,
+                       DolphinServiceMenuCache *serviceMenuCache,
+                       const KFileItemListProperties *selectedItemsProperties = nullptr);
 
     ~DolphinContextMenu() override;
 
@@ -132,6 +138,7 @@ private:
 
     DolphinRemoveAction *m_removeAction; // Action that represents either 'Move To Trash' or 'Delete'
     KFileItemActions *m_fileItemActions;
+    DolphinServiceMenuCache *m_serviceMenuCache;
 };
 
 #endif
@@ -0,0 +1,329 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinlocationindex.h"
+
+#include "dolphindebug.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QUrl>
+
+#include <algorithm>
+
+namespace
+{
+// Maximum number of locations in the index. If exceeded, the locations with
+// the lowest weights are removed until MinLocations locations are left.
+constexpr int MaxLocations = 2000;
+constexpr int MinLocations = 1800;
+
+// Minimum weights of the locations that have not (only) been visited
+constexpr quint32 PlaceWeight = 5;
+constexpr quint32 BookmarkWeight = 5;
+constexpr quint32 ClosedTabWeight = 2;
+
+constexpr int SaveDelay = 5000;
+
+constexpr quint32 FileVersion = 1;
+}
+
+DolphinLocationIndex::DolphinLocationIndex(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , m_filePath(filePath)
+    , m_saveTimer(nullptr)
+    , m_hasPendingChanges(false)
+    , m_locations()
+    , m_locationIndexes()
+    , m_trie(1)
+{
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SaveDelay);
+    connect(m_saveTimer, &QTimer::timeout, this, &DolphinLocationIndex::save);
+
+    load();
+}
+
+DolphinLocationIndex::~DolphinLocationIndex()
+{
+    save();
+}
+
+DolphinLocationIndex &DolphinLocationIndex::instance()
+{
+    // The index is owned by the application, so that it is saved and
+    // destroyed before the application, and not during the static destruction.
+    static QPointer<DolphinLocationIndex> s_instance;
+    if (!s_instance) {
+        QCoreApplication *app = QCoreApplication::instance();
+        s_instance = new DolphinLocationIndex(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1String("/locationindex"), app);
+        if (app) {
+            connect(app, &QCoreApplication::aboutToQuit, s_instance, &DolphinLocationIndex::save);
+        }
+    }
+    return *s_instance;
+}
+
+void DolphinLocationIndex::addLocation(const QUrl &url, Source source)
+{
+    if (!url.isValid()) {
+        return;
+    }
+
+    const QString location = locationText(url);
+    if (location.isEmpty()) {
+        return;
+    }
+
+    const int index = m_locationIndexes.value(location, -1);
+    const quint32 weight = (index >= 0) ? m_locations.at(index).weight : 0;
+
+    switch (source) {
+    case VisitedLocation:
+        setWeight(location, weight + 1);
+        break;
+    case Place:
+        setWeight(location, std::max(weight, PlaceWeight));
+        break;
+    case Bookmark:
+        setWeight(location, std::max(weight, BookmarkWeight));
+        break;
+    case ClosedTab:
+        setWeight(location, std::max(weight, ClosedTabWeight));
+        break;
+    }
+}
+
+QStringList DolphinLocationIndex::completions(const QString &prefix, int maxCount) const
+{
+    if (prefix.isEmpty() || maxCount <= 0) {
+        return {};
+    }
+
+    // Find the node of the prefix
+    int nodeIndex = 0;
+    for (const QChar c : prefix) {
+        const auto &children = m_trie[nodeIndex].children;
+        const auto it = std::lower_bound(children.begin(), children.end(), c.unicode(), [](const std::pair<char16_t, int> &child, char16_t c) {
+            return child.first < c;
+        });
+        if (it == children.end() || it->first != c.unicode()) {
+            return {};
+        }
+        nodeIndex = it->second;
+    }
+
+    // Collect all locations below the node
+    std::vector<int> locationIndexes;
+    std::vector<int> pendingNodes{nodeIndex};
+    while (!pendingNodes.empty()) {
+        const Node &node = m_trie[pendingNodes.back()];
+        pendingNodes.pop_back();
+
+        if (node.locationIndex >= 0) {
+            locationIndexes.push_back(node.locationIndex);
+        }
+        for (const auto &child : node.children) {
+            pendingNodes.push_back(child.second);
+        }
+    }
+
+    const auto higherWeight = [this](int a, int b) {
+        const Location &locationA = m_locations.at(a);
+        const Location &locationB = m_locations.at(b);
+        if (locationA.weight != locationB.weight) {
+            return locationA.weight > locationB.weight;
+        }
+        return locationA.text < locationB.text;
+    };
+
+    const int resultCount = std::min<int>(maxCount, locationIndexes.size());
+    std::partial_sort(locationIndexes.begin(), locationIndexes.begin() + resultCount, locationIndexes.end(), higherWeight);
+
+    QStringList result;
+    result.reserve(resultCount);
+    for (int i = 0; i < resultCount; ++i) {
+        result.append(m_locations.at(locationIndexes[i]).text);
+    }
+    return result;
+}
+
+int DolphinLocationIndex::count() const
+{
+    return m_locations.count();
+}
+
+void DolphinLocationIndex::clear()
+{
+    m_locations.clear();
+    m_locationIndexes.clear();
+    rebuildTrie();
+    scheduleSave();
+}
+
+void DolphinLocationIndex::save()
+{
+    if (m_filePath.isEmpty() || !m_hasPendingChanges) {
+        return;
+    }
+    m_saveTimer->stop();
+    m_hasPendingChanges = false;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(DolphinDebug) << "Cannot save the location index to" << m_filePath;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << FileVersion << quint32(m_locations.count());
+    for (const Location &location : std::as_const(m_locations)) {
+        stream << location.text << location.weight;
+    }
+
+    if (!file.commit()) {
+        qCWarning(DolphinDebug) << "Cannot save the location index to" << m_filePath;
+    }
+}
+
+void DolphinLocationIndex::load()
+{
+    if (m_filePath.isEmpty()) {
+        return;
+    }
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> version >> count;
+    if (version != FileVersion) {
+        return;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        Location location;
+        stream >> location.text >> location.weight;
+        if (stream.status() == QDataStream::Ok && !location.text.isEmpty() && !m_locationIndexes.contains(location.text)) {
+            m_locationIndexes.insert(location.text, m_locations.count());
+            m_locations.append(location);
+        }
+    }
+
+    removeLowWeightLocations();
+    rebuildTrie();
+}
+
+void DolphinLocationIndex::scheduleSave()
+{
+    if (!m_filePath.isEmpty()) {
+        m_hasPendingChanges = true;
+        m_saveTimer->start();
+    }
+}
+
+void DolphinLocationIndex::setWeight(const QString &location, quint32 weight)
+{
+    const int index = m_locationIndexes.value(location, -1);
+    if (index >= 0) {
+        if (m_locations.at(index).weight == weight) {
+            return;
+        }
+        m_locations[index].weight = weight;
+    } else {
+        const int newIndex = m_locations.count();
+        m_locations.append({location, weight});
+        m_locationIndexes.insert(location, newIndex);
+        if (m_locations.count() > MaxLocations) {
+            removeLowWeightLocations();
+            rebuildTrie();
+        } else {
+            insertIntoTrie(location, newIndex);
+        }
+    }
+
+    scheduleSave();
+}
+
+void DolphinLocationIndex::removeLowWeightLocations()
+{
+    if (m_locations.count() <= MaxLocations) {
+        return;
+    }
+
+    // Prefer the most recently added locations if the weights are equal.
+    std::reverse(m_locations.begin(), m_locations.end());
+    std::stable_sort(m_locations.begin(), m_locations.end(), [](const Location &a, const Location &b) {
+        return a.weight > b.weight;
+    });
+    m_locations.resize(MinLocations);
+
+    // Halve the weights, so that locations which have been visited often
+    // a long time ago can be replaced by the currently visited ones.
+    for (Location &location : m_locations) {
+        location.weight = (location.weight + 1) / 2;
+    }
+
+    m_locationIndexes.clear();
+    for (int i = 0; i < m_locations.count(); ++i) {
+        m_locationIndexes.insert(m_locations.at(i).text, i);
+    }
+}
+
+void DolphinLocationIndex::rebuildTrie()
+{
+    m_trie.clear();
+    m_trie.resize(1);
+    for (int i = 0; i < m_locations.count(); ++i) {
+        insertIntoTrie(m_locations.at(i).text, i);
+    }
+}
+
+void DolphinLocationIndex::insertIntoTrie(const QString &location, int locationIndex)
+{
+    int nodeIndex = 0;
+    for (const QChar c : location) {
+        auto &children = m_trie[nodeIndex].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c.unicode(), [](const std::pair<char16_t, int> &child, char16_t c) {
+            return child.first < c;
+        });
+        if (it == children.end() || it->first != c.unicode()) {
+            const int childIndex = m_trie.size();
+            it = children.insert(it, {c.unicode(), childIndex});
+            // Note that resizing m_trie invalidates the reference to children
+            m_trie.emplace_back();
+            nodeIndex = childIndex;
+        } else {
+            nodeIndex = it->second;
+        }
+    }
+    m_trie[nodeIndex].locationIndex = locationIndex;
+}
+
+QString DolphinLocationIndex::locationText(const QUrl &url)
+{
+    const QUrl adjustedUrl = url.adjusted(QUrl::StripTrailingSlash | QUrl::NormalizePathSegments);
+    if (adjustedUrl.isLocalFile()) {
+        const QString path = adjustedUrl.toLocalFile();
+        return path.isEmpty() ? QStringLiteral("/") : path;
+    }
+    return adjustedUrl.toDisplayString();
+}
+
+#include "moc_dolphinlocationindex.cpp"
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINLOCATIONINDEX_H
+#define DOLPHINLOCATIONINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+class QTimer;
+class QUrl;
+
+/**
+ * @brief In-memory index of known locations for completing URLs.
+ *
+ * Contains the visited locations, the places, the bookmarks and the recently
+ * closed tabs. Each location has a weight that increases with each visit. The
+ * locations are stored in a prefix trie, so that the completions for a typed
+ * text can be answered without accessing the file system, which might block
+ * for slow or automounted locations.
+ *
+ * The index is saved between sessions. Changes are written with a small delay
+ * to coalesce subsequent changes.
+ */
+class DolphinLocationIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Source {
+        VisitedLocation,
+        Place,
+        Bookmark,
+        ClosedTab
+    };
+
+    /**
+     * @param filePath File the index is loaded from and saved to. If empty,
+     *                 the index is not persistent.
+     */
+    explicit DolphinLocationIndex(const QString &filePath = QString(), QObject *parent = nullptr);
+    ~DolphinLocationIndex() override;
+
+    /**
+     * @return Index that is shared by all windows of the application. Pending
+     *         changes are saved when the application is about to quit.
+     */
+    static DolphinLocationIndex &instance();
+
+    /**
+     * Adds the location \a url to the index. Visiting a location increases its
+     * weight, places, bookmarks and closed tabs get a minimum weight.
+     */
+    void addLocation(const QUrl &url, Source source);
+
+    /**
+     * @return Up to \a maxCount locations that start with \a prefix, the
+     *         locations with the highest weight first. The locations use
+     *         the same notation as the editable location bar, so local
+     *         files are given as paths.
+     */
+    QStringList completions(const QString &prefix, int maxCount) const;
+
+    /**
+     * @return Number of locations in the index.
+     */
+    int count() const;
+
+    void clear();
+
+    /**
+     * Writes pending changes to the file of the index.
+     */
+    void save();
+
+private:
+    void load();
+    void scheduleSave();
+    void setWeight(const QString &location, quint32 weight);
+
+    /**
+     * Removes the locations with the lowest weights if the index contains
+     * too many locations, and halves the weights of the remaining ones.
+     * The trie must be rebuilt afterwards.
+     */
+    void removeLowWeightLocations();
+
+    void rebuildTrie();
+    void insertIntoTrie(const QString &location, int locationIndex);
+
+    static QString locationText(const QUrl &url);
+
+private:
+    struct Location {
+        QString text;
+        quint32 weight;
+    };
+
+    struct Node {
+        // Children sorted by character
+        std::vector<std::pair<char16_t, int>> children;
+        // Index into m_locations if a location ends at this node, otherwise -1
+        int locationIndex = -1;
+    };
+
+    QString m_filePath;
+    QTimer *m_saveTimer;
+    bool m_hasPendingChanges;
+
+    QList<Location> m_locations;
+    QHash<QString, int> m_locationIndexes;
+
+    // m_trie[0] is the root node
+    std::vector<Node> m_trie;
+};
+
+#endif // DOLPHINLOCATIONINDEX_H
@@ -18,6 +18,7 @@
 #include "dolphinnewfilemenu.h"
 #include "dolphinplacesmodelsingleton.h"
 #include "dolphinrecenttabsmenu.h"
+#include "dolphinservicemenucache.h"
 #include "dolphintabpage.h"
 #include "dolphinurlnavigatorscontroller.h"
 #include "dolphinviewcontainer.h"
@@ -87,6 +88,7 @@
 #include <QMenuBar>
 #include <QPushButton>
 #include <QScopeGuard>
+#include <QSet>
 #include <QSharedPointer>
 #include <QShowEvent>
 #include <QStandardPaths>
@@ -208,6 +210,8 @@ DolphinMainWindow::DolphinMainWindow()
 #if KIO_VERSION >= QT_VERSION_CHECK(6, 24, 0)
     m_serviceMenuShortcutManager = new ServiceMenuShortcutManager(actionCollection(), this);
 #endif
+    m_serviceMenuCache = new DolphinServiceMenuCache(this, this);
+    connect(m_serviceMenuCache, &DolphinServiceMenuCache::error, this, &DolphinMainWindow::showErrorMessage);
     setupFileItemActions();
 
     const bool usePhoneUi{KRuntimePlatform::runtimePlatform().contains(QLatin1String("phone"))};
@@ -259,6 +263,11 @@ DolphinMainWindow::DolphinMainWindow()
     setupWhatsThis();
 
     connect(KSycoca::self(), &KSycoca::databaseChanged, this, &DolphinMainWindow::updateOpenPreferredSearchToolAction);
+    connect(KSycoca::self(), &KSycoca::databaseChanged, this, &DolphinMainWindow::clearItemListPropertiesCache);
+    // The service menus are matched against the MIME types of the database
+    connect(KSycoca::self(), &KSycoca::databaseChanged, this, &DolphinMainWindow::setupFileItemActions);
+    // The capabilities of refreshed items might have changed, e.g. after a chmod
+    connect(this, &DolphinMainWindow::fileItemsChanged, this, &DolphinMainWindow::clearItemListPropertiesCache);
 
     QTimer::singleShot(0, this, &DolphinMainWindow::updateOpenPreferredSearchToolAction);
 
@@ -404,11 +413,12 @@ void DolphinMainWindow::slotEditableStateChanged(bool editable)
 
 void DolphinMainWindow::slotSelectionChanged(const KFileItemList &selection)
 {
+    clearItemListPropertiesCache();
     updateFileAndEditActions();
 
     if (m_fileItemActions) {
         if (selection.count() > 0) {
-            m_fileItemActions->setItemListProperties(KFileItemListProperties(selection));
+            m_fileItemActions->setItemListProperties(itemListProperties(selection));
         } else {
             m_fileItemActions->setItemListProperties(KFileItemListProperties(KFileItemList() << m_activeViewContainer->rootItem()));
         }
@@ -956,6 +966,38 @@ void DolphinMainWindow::updatePasteAction()
 void DolphinMainWindow::slotDirectoryLoadingCompleted()
 {
     updatePasteAction();
+    prepareServiceMenus();
+}
+
+void DolphinMainWindow::prepareServiceMenus()
+{
+    // Limits the work done after loading a folder with many different file types
+    const int maximumMimeTypeCount = 32;
+
+    const DolphinView *view = m_activeViewContainer->view();
+    QList<KFileItemList> itemLists;
+
+    const KFileItem rootItem = view->rootItem();
+    if (!rootItem.isNull()) {
+        itemLists.append(KFileItemList{rootItem});
+    }
+
+    QSet<QString> mimeTypes;
+    const KFileItemList items = view->items();
+    for (const KFileItem &item : items) {
+        // The MIME type is only determined by the name here, the content
+        // gets read when the cache creates the actions.
+        const QString mimeType = item.currentMimeType().name();
+        if (!mimeTypes.contains(mimeType)) {
+            mimeTypes.insert(mimeType);
+            itemLists.append(KFileItemList{item});
+            if (mimeTypes.count() >= maximumMimeTypeCount) {
+                break;
+            }
+        }
+    }
+
+    m_serviceMenuCache->prepare(itemLists);
 }
 
 void DolphinMainWindow::slotToolBarActionMiddleClicked(QAction *action)
@@ -1537,7 +1579,14 @@ void DolphinMainWindow::openContextMenu(const QPoint &pos, const KFileItem &item
         }
     });
 
-    QPointer<DolphinContextMenu> contextMenu = new DolphinContextMenu(this, item, selectedItems, url, m_fileItemActions);
+    QPointer<DolphinContextMenu> contextMenu =
+        new DolphinContextMenu(this,
+                               item,
+                               selectedItems,
+                               url,
+                               m_fileItemActions,
+                               m_serviceMenuCache,
+                               selectedItems.isEmpty() ? nullptr : &itemListProperties(selectedItems));
     contextMenu->exec(pos);
     delete contextMenu;
 }
@@ -2614,6 +2663,8 @@ void DolphinMainWindow::setupFileItemActions()
     }
     m_fileItemActionsSetupPending = false;
 
+    m_serviceMenuCache->clear();
+
     delete m_fileItemActions;
     m_fileItemActions = new KFileItemActions(this);
     m_fileItemActions->setParentWidget(this);
@@ -2626,11 +2677,27 @@ void DolphinMainWindow::setupFileItemActions()
 #endif
 }
 
+const KFileItemListProperties &DolphinMainWindow::itemListProperties(const KFileItemList &items)
+{
+    if (!m_itemListPropertiesCached || m_cachedPropertiesItems != items) {
+        m_cachedPropertiesItems = items;
+        m_cachedItemListProperties.setItems(items);
+        m_itemListPropertiesCached = true;
+    }
+    return m_cachedItemListProperties;
+}
+
+void DolphinMainWindow::clearItemListPropertiesCache()
+{
+    m_itemListPropertiesCached = false;
+    m_cachedPropertiesItems.clear();
+}
+
 void DolphinMainWindow::updateFileAndEditActions()
 {
     const KFileItemList list = m_activeViewContainer->view()->selectedItems();
     const KActionCollection *col = actionCollection();
-    KFileItemListProperties capabilitiesSource(list);
+    const KFileItemListProperties &capabilitiesSource = itemListProperties(list);
 
     QAction *renameAction = col->action(KStandardAction::name(KStandardAction::RenameFile));
     QAction *moveToTrashAction = col->action(KStandardAction::name(KStandardAction::MoveToTrash));
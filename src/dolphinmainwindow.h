@@ -16,6 +16,7 @@
 #include <KActionMenu>
 #include <KConfigWatcher>
 #include <KFileItemActions>
+#include <KFileItemListProperties>
 #include <kio/fileundomanager.h>
 #include <kxmlguiwindow.h>
 
@@ -39,6 +40,7 @@ class DolphinViewActionHandler;
 class DolphinSettingsDialog;
 class DolphinViewContainer;
 class DolphinRemoteEncoding;
+class DolphinServiceMenuCache;
 class DolphinTabWidget;
 class KFileItem;
 class KFileItemList;
@@ -634,6 +636,13 @@ private Q_SLOTS:
      */
     void slotDirectoryLoadingCompleted();
 
+    /**
+     * Creates the service menu actions for the folder and for each MIME type
+     * of the items of the active view in the background, so that opening a
+     * context menu can reuse them.
+     */
+    void prepareServiceMenus();
+
     /**
      * Is called when the user middle clicks a toolbar button.
      *
@@ -700,11 +709,22 @@ private:
     void setupDockWidgets();
 
     /**
-     * Initializes or re-initializes the KFileItemActions instance. Deferred while a
-     * context menu is holding on to the current instance, see openContextMenu().
+     * Initializes or re-initializes the KFileItemActions instance and clears the
+     * cached service menu actions. Deferred while a context menu is holding on to
+     * the current instance, see openContextMenu().
      */
     void setupFileItemActions();
 
+    /**
+     * @return Properties of \a items. The properties of the last requested item list
+     *         are cached, so that they are computed only once for a selection although
+     *         the actions, the file item actions and the context menu require them.
+     *         The cache is invalidated if the selection or the items change, or if the
+     *         KSycoca database changes.
+     */
+    const KFileItemListProperties &itemListProperties(const KFileItemList &items);
+    void clearItemListPropertiesCache();
+
     void updateFileAndEditActions();
     void updateViewActions();
     void updateGoActions();
@@ -803,6 +823,10 @@ private:
     QMenu m_searchTools;
     KConfigWatcher::Ptr m_serviceMenuConfigWatcher;
     KFileItemActions *m_fileItemActions = nullptr;
+    DolphinServiceMenuCache *m_serviceMenuCache = nullptr;
+    KFileItemList m_cachedPropertiesItems;
+    KFileItemListProperties m_cachedItemListProperties;
+    bool m_itemListPropertiesCached = false;
     bool m_contextMenuOpen = false;
     bool m_fileItemActionsSetupPending = false;
     ServiceMenuShortcutManager *m_serviceMenuShortcutManager = nullptr;
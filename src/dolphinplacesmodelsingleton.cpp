@@ -5,6 +5,7 @@
  */
 
 #include "dolphinplacesmodelsingleton.h"
+#include "dolphinlocationindex.h"
 #include "trash/dolphintrash.h"
 #include "views/draganddrophelper.h"
 
@@ -18,6 +19,11 @@ DolphinPlacesModel::DolphinPlacesModel(QObject *parent)
     : KFilePlacesModel(parent)
 {
     connect(&Trash::instance(), &Trash::emptinessChanged, this, &DolphinPlacesModel::slotTrashEmptinessChanged);
+
+    connect(this, &KFilePlacesModel::rowsInserted, this, &DolphinPlacesModel::addPlacesToLocationIndex);
+    connect(this, &KFilePlacesModel::dataChanged, this, &DolphinPlacesModel::addPlacesToLocationIndex);
+    connect(this, &KFilePlacesModel::modelReset, this, &DolphinPlacesModel::addPlacesToLocationIndex);
+    addPlacesToLocationIndex();
 }
 
 DolphinPlacesModel::~DolphinPlacesModel() = default;
@@ -113,6 +119,18 @@ void DolphinPlacesModel::slotTrashEmptinessChanged(bool isEmpty)
     }
 }
 
+void DolphinPlacesModel::addPlacesToLocationIndex()
+{
+    DolphinLocationIndex &locationIndex = DolphinLocationIndex::instance();
+    for (int row = 0; row < rowCount(); ++row) {
+        const QModelIndex placeIndex = index(row, 0);
+        const QUrl placeUrl = url(placeIndex);
+        if (!placeUrl.isEmpty() && !isHidden(placeIndex)) {
+            locationIndex.addLocation(placeUrl, DolphinLocationIndex::Place);
+        }
+    }
+}
+
 bool DolphinPlacesModel::isTrash(const QModelIndex &index) const
 {
     return url(index) == QUrl(QStringLiteral("trash:/"));
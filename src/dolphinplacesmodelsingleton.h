@@ -38,6 +38,12 @@ protected:
 private Q_SLOTS:
     void slotTrashEmptinessChanged(bool isEmpty);
 
+    /**
+     * Adds the places to the DolphinLocationIndex, so that they can
+     * be completed in the location bar.
+     */
+    void addPlacesToLocationIndex();
+
 private:
     bool isTrash(const QModelIndex &index) const;
 
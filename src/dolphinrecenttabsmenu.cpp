@@ -5,6 +5,7 @@
  */
 
 #include "dolphinrecenttabsmenu.h"
+#include "dolphinlocationindex.h"
 #include "search/dolphinquery.h"
 
 #include <KAcceleratorManager>
@@ -36,6 +37,7 @@ void DolphinRecentTabsMenu::rememberClosedTab(const QUrl &url, const QByteArray
         action->setText(Search::DolphinQuery{url, QUrl{}}.title());
     } else {
         action->setText(url.path());
+        DolphinLocationIndex::instance().addLocation(url, DolphinLocationIndex::ClosedTab);
     }
     action->setData(state);
     const QString iconName = KIO::iconNameForUrl(url);
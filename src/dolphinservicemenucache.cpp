@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinservicemenucache.h"
+
+#include <KFileItemActions>
+#include <KFileItemListProperties>
+
+#include <QMenu>
+#include <QTimer>
+
+namespace
+{
+// Maximum number of cached item list combinations
+constexpr int MaximumEntryCount = 64;
+}
+
+DolphinServiceMenuCache::DolphinServiceMenuCache(QWidget *parentWidget, QObject *parent)
+    : QObject(parent)
+    , m_parentWidget(parentWidget)
+    , m_entries(MaximumEntryCount)
+    , m_pendingItemLists()
+    , m_prepareTimer(nullptr)
+{
+    m_prepareTimer = new QTimer(this);
+    m_prepareTimer->setSingleShot(true);
+    m_prepareTimer->setInterval(0);
+    connect(m_prepareTimer, &QTimer::timeout, this, &DolphinServiceMenuCache::prepareNextItemList);
+}
+
+DolphinServiceMenuCache::~DolphinServiceMenuCache()
+{
+}
+
+void DolphinServiceMenuCache::addActionsTo(QMenu *menu, const KFileItemListProperties &props)
+{
+    const QString key = keyOf(props);
+    Entry *entry = m_entries.object(key);
+    if (!entry) {
+        entry = createEntry(key, props);
+    }
+
+    // KFileItemActions applies a triggered action to its current items
+    entry->fileItemActions->setItemListProperties(props);
+    menu->addActions(entry->menu->actions());
+}
+
+void DolphinServiceMenuCache::prepare(const QList<KFileItemList> &itemLists)
+{
+    m_pendingItemLists = itemLists;
+    if (m_pendingItemLists.isEmpty()) {
+        m_prepareTimer->stop();
+    } else {
+        m_prepareTimer->start();
+    }
+}
+
+int DolphinServiceMenuCache::count() const
+{
+    return m_entries.count();
+}
+
+void DolphinServiceMenuCache::clear()
+{
+    m_prepareTimer->stop();
+    m_pendingItemLists.clear();
+    m_entries.clear();
+}
+
+void DolphinServiceMenuCache::prepareNextItemList()
+{
+    while (!m_pendingItemLists.isEmpty()) {
+        const KFileItemListProperties props(m_pendingItemLists.takeFirst());
+        const QString key = keyOf(props);
+        if (!m_entries.contains(key)) {
+            createEntry(key, props);
+            break;
+        }
+    }
+
+    if (!m_pendingItemLists.isEmpty()) {
+        m_prepareTimer->start();
+    }
+}
+
+QString DolphinServiceMenuCache::keyOf(const KFileItemListProperties &props)
+{
+    QStringList mimeTypes = props.mimeTypeList();
+    mimeTypes.removeDuplicates();
+    mimeTypes.sort();
+
+    QStringList schemes;
+    const QList<QUrl> urls = props.urlList();
+    for (const QUrl &url : urls) {
+        if (!schemes.contains(url.scheme())) {
+            schemes.append(url.scheme());
+        }
+    }
+    schemes.sort();
+
+    const int capabilities = (props.isLocal() ? 0x01 : 0) | (props.isDirectory() ? 0x02 : 0) | (props.isFile() ? 0x04 : 0)
+        | (props.supportsReading() ? 0x08 : 0) | (props.supportsDeleting() ? 0x10 : 0) | (props.supportsWriting() ? 0x20 : 0)
+        | (props.supportsMoving() ? 0x40 : 0);
+
+    return mimeTypes.join(QLatin1Char(',')) + QLatin1Char('|') + schemes.join(QLatin1Char(',')) + QLatin1Char('|') + QString::number(urls.count())
+        + QLatin1Char('|') + QString::number(capabilities);
+}
+
+DolphinServiceMenuCache::Entry *DolphinServiceMenuCache::createEntry(const QString &key, const KFileItemListProperties &props)
+{
+    Entry *entry = new Entry;
+    entry->fileItemActions = std::make_unique<KFileItemActions>();
+    entry->fileItemActions->setParentWidget(m_parentWidget);
+    connect(entry->fileItemActions.get(), &KFileItemActions::error, this, &DolphinServiceMenuCache::error);
+    entry->fileItemActions->setItemListProperties(props);
+
+    // The menu is never shown, it only holds the actions and submenus
+    entry->menu = std::make_unique<QMenu>();
+    entry->fileItemActions->addActionsTo(entry->menu.get(), KFileItemActions::MenuActionSource::Services);
+
+    m_entries.insert(key, entry);
+    return entry;
+}
+
+#include "moc_dolphinservicemenucache.cpp"
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINSERVICEMENUCACHE_H
+#define DOLPHINSERVICEMENUCACHE_H
+
+#include <KFileItem>
+
+#include <QCache>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+class KFileItemActions;
+class KFileItemListProperties;
+class QMenu;
+class QTimer;
+class QWidget;
+
+/**
+ * @brief Cache for the service menu actions of the context menu.
+ *
+ * Creating the service menu actions requires reading all installed service
+ * menus and matching them against the MIME types of the items. As the
+ * service menus only depend on the MIME types, the protocols, the number
+ * and the capabilities of the items, the actions are created once for each
+ * combination and reused for all context menus with the same combination.
+ * Conditions that may change at runtime, like X-KDE-ShowIfRunning, are
+ * evaluated when the actions get created.
+ *
+ * The actions for the items of a folder can be created in advance by
+ * prepare(), so that opening a context menu does not need to create them.
+ * The cache must be cleared when the installed service menus or the
+ * MIME types change.
+ */
+class DolphinServiceMenuCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param parentWidget Parent widget of the dialogs opened by the actions.
+     */
+    explicit DolphinServiceMenuCache(QWidget *parentWidget, QObject *parent = nullptr);
+    ~DolphinServiceMenuCache() override;
+
+    /**
+     * Adds the service menu actions for the items of \a props to \a menu.
+     * The actions get created if they are not cached yet. Triggering an
+     * action applies it to the items of \a props.
+     */
+    void addActionsTo(QMenu *menu, const KFileItemListProperties &props);
+
+    /**
+     * Creates the actions for each list of \a itemLists in the background,
+     * one list per event loop iteration. The lists pending from a previous
+     * call are discarded.
+     */
+    void prepare(const QList<KFileItemList> &itemLists);
+
+    /**
+     * @return Number of cached item list combinations.
+     */
+    int count() const;
+
+    void clear();
+
+Q_SIGNALS:
+    void error(const QString &errorMessage);
+
+private Q_SLOTS:
+    void prepareNextItemList();
+
+private:
+    struct Entry {
+        std::unique_ptr<KFileItemActions> fileItemActions;
+        std::unique_ptr<QMenu> menu;
+    };
+
+    /**
+     * @return Key of the combination of MIME types, protocols, number and
+     *         capabilities of the items of \a props.
+     */
+    static QString keyOf(const KFileItemListProperties &props);
+
+    Entry *createEntry(const QString &key, const KFileItemListProperties &props);
+
+    QWidget *m_parentWidget;
+    QCache<QString, Entry> m_entries;
+    QList<KFileItemList> m_pendingItemLists;
+    QTimer *m_prepareTimer;
+};
+
+#endif
@@ -23,12 +23,13 @@ void resetSplitterSizes(QSplitter *splitter)
 }
 }
 
-DolphinTabPage::DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl, QWidget *parent)
+DolphinTabPage::DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl, QWidget *parent, bool loadingDeferred)
     : QWidget(parent)
     , m_expandingContainer{nullptr}
     , m_primaryViewActive(true)
     , m_splitViewEnabled(false)
     , m_active(true)
+    , m_loadingDeferred(loadingDeferred)
     , m_splitterLastPosition(0)
 {
     QGridLayout *layout = new QGridLayout(this);
@@ -420,6 +421,20 @@ void DolphinTabPage::setActive(bool active)
     connectViewActivatedSignals();
 }
 
+void DolphinTabPage::setLoadingDeferred(bool deferred)
+{
+    m_loadingDeferred = deferred;
+    m_primaryViewContainer->view()->setLoadingDeferred(deferred);
+    if (m_secondaryViewContainer) {
+        m_secondaryViewContainer->view()->setLoadingDeferred(deferred);
+    }
+}
+
+bool DolphinTabPage::isLoadingDeferred() const
+{
+    return m_loadingDeferred;
+}
+
 void DolphinTabPage::setCustomLabel(const QString &label)
 {
     m_customLabel = label;
@@ -559,7 +574,7 @@ void DolphinTabPage::disconnectViewActivatedSignals()
 
 DolphinViewContainer *DolphinTabPage::createViewContainer(const QUrl &url) const
 {
-    DolphinViewContainer *container = new DolphinViewContainer(url, m_splitter);
+    DolphinViewContainer *container = new DolphinViewContainer(url, m_splitter, m_loadingDeferred);
     container->setActive(false);
 
     const DolphinView *view = container->view();
@@ -26,7 +26,11 @@ class DolphinTabPage : public QWidget
     Q_OBJECT
 
 public:
-    explicit DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl = QUrl(), QWidget *parent = nullptr);
+    /**
+     * @param loadingDeferred If true, the views are created without loading
+     *                        their directories. @see setLoadingDeferred()
+     */
+    explicit DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl = QUrl(), QWidget *parent = nullptr, bool loadingDeferred = false);
 
     /**
      * @return True if primary view is the active view in this tab.
@@ -132,6 +136,15 @@ public:
      */
     void restoreState(const QByteArray &state);
 
+    /**
+     * If set to true, the views do not load their directories until
+     * loading gets enabled again. Is used for restored tabs that have
+     * not been activated yet.
+     * @see DolphinView::setLoadingDeferred()
+     */
+    void setLoadingDeferred(bool deferred);
+    bool isLoadingDeferred() const;
+
     /**
      * Set whether the tab page is active
      *
@@ -228,6 +241,7 @@ private:
     bool m_primaryViewActive;
     bool m_splitViewEnabled;
     bool m_active;
+    bool m_loadingDeferred;
     /** @see setCustomLabel(). */
     QString m_customLabel;
     int m_splitterLastPosition = 0;
@@ -22,14 +22,27 @@
 #include <QApplication>
 #include <QDropEvent>
 #include <QStackedWidget>
+#include <QTimer>
+
+namespace
+{
+// Delay in ms between loading the directories of two restored tabs in the background
+constexpr int WarmUpInterval = 1000;
+}
 
 DolphinTabWidget::DolphinTabWidget(DolphinNavigatorsWidgetAction *navigatorsWidget, QWidget *parent)
     : QTabWidget(parent)
     , m_lastViewedTab(nullptr)
+    , m_warmUpTimer(nullptr)
     , m_navigatorsWidget{navigatorsWidget}
 {
     KAcceleratorManager::setNoAccel(this);
 
+    m_warmUpTimer = new QTimer(this);
+    m_warmUpTimer->setSingleShot(true);
+    m_warmUpTimer->setInterval(WarmUpInterval);
+    connect(m_warmUpTimer, &QTimer::timeout, this, &DolphinTabWidget::warmUpNextRestoredTab);
+
     connect(this, &DolphinTabWidget::tabCloseRequested, this, QOverload<int>::of(&DolphinTabWidget::closeTab));
     connect(this, &DolphinTabWidget::currentChanged, this, &DolphinTabWidget::currentTabChanged);
 
@@ -92,17 +105,34 @@ void DolphinTabWidget::saveProperties(KConfigGroup &group) const
 void DolphinTabWidget::readProperties(const KConfigGroup &group)
 {
     const int tabCount = group.readEntry("Tab Count", 0);
+    const int index = group.readEntry("Active Tab Index", 0);
     for (int i = 0; i < tabCount; ++i) {
+        // Only the active tab loads its directories. The directories of the
+        // background tabs get loaded as soon as the tab gets activated, so
+        // their views are created with deferred loading and the tabs are
+        // not made current while restoring.
+        const bool loadingDeferred = (i != index && GeneralSettings::lazyTabRestoration());
         if (i >= count()) {
-            openNewActivatedTab();
+            openNewTab(currentTabPage()->activeViewContainer()->url(), QUrl(), NewTabPosition::AtEnd, loadingDeferred);
         }
+
+        DolphinTabPage *tabPage = tabPageAt(i);
         const QByteArray state = group.readEntry("Tab Data " % QString::number(i), QByteArray());
-        setCurrentIndex(i);
-        tabPageAt(i)->restoreState(state);
+        if (loadingDeferred) {
+            tabPage->setLoadingDeferred(true);
+            tabPage->restoreState(state);
+            tabPage->setActive(false);
+        } else {
+            setCurrentIndex(i);
+            tabPage->restoreState(state);
+        }
     }
 
-    const int index = group.readEntry("Active Tab Index", 0);
     setCurrentIndex(index);
+
+    if (GeneralSettings::lazyTabRestoration() && GeneralSettings::warmUpRestoredTabs()) {
+        m_warmUpTimer->start();
+    }
 }
 
 void DolphinTabWidget::refreshViews()
@@ -185,11 +215,11 @@ void DolphinTabWidget::openNewActivatedTab(const QUrl &primaryUrl, const QUrl &s
     }
 }
 
-DolphinTabPage *DolphinTabWidget::openNewTab(const QUrl &primaryUrl, const QUrl &secondaryUrl, DolphinTabWidget::NewTabPosition position)
+DolphinTabPage *DolphinTabWidget::openNewTab(const QUrl &primaryUrl, const QUrl &secondaryUrl, DolphinTabWidget::NewTabPosition position, bool loadingDeferred)
 {
     QWidget *focusWidget = QApplication::focusWidget();
 
-    DolphinTabPage *tabPage = new DolphinTabPage(primaryUrl, secondaryUrl, this);
+    DolphinTabPage *tabPage = new DolphinTabPage(primaryUrl, secondaryUrl, this, loadingDeferred);
     tabPage->setActive(false);
     connect(tabPage, &DolphinTabPage::activeViewChanged, this, &DolphinTabWidget::activeViewChanged);
     connect(tabPage, &DolphinTabPage::activeViewUrlChanged, this, &DolphinTabWidget::tabUrlChanged);
@@ -481,6 +511,7 @@ void DolphinTabWidget::currentTabChanged(int index)
     if (tabPage == m_lastViewedTab) {
         return;
     }
+    tabPage->setLoadingDeferred(false);
     if (m_lastViewedTab) {
         m_lastViewedTab->disconnectNavigators();
         m_lastViewedTab->setActive(false);
@@ -647,4 +678,16 @@ const std::optional<const DolphinTabWidget::ViewIndex> DolphinTabWidget::viewSho
     return std::nullopt;
 }
 
+void DolphinTabWidget::warmUpNextRestoredTab()
+{
+    for (int i = 0; i < count(); ++i) {
+        DolphinTabPage *tabPage = tabPageAt(i);
+        if (tabPage->isLoadingDeferred()) {
+            tabPage->setLoadingDeferred(false);
+            m_warmUpTimer->start();
+            return;
+        }
+    }
+}
+
 #include "moc_dolphintabwidget.cpp"
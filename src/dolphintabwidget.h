@@ -16,6 +16,7 @@
 #include <optional>
 
 class DolphinViewContainer;
+class QTimer;
 class KConfigGroup;
 
 class DolphinTabWidget : public QTabWidget
@@ -131,12 +132,14 @@ public Q_SLOTS:
 
     /**
      * Opens a new tab in the background showing the URL \a primaryUrl and the
-     * optional URL \a secondaryUrl.
+     * optional URL \a secondaryUrl. If \a loadingDeferred is true, the
+     * directories are not loaded until the tab gets activated.
      * @return A pointer to the opened DolphinTabPage.
      */
     DolphinTabPage *openNewTab(const QUrl &primaryUrl,
                                const QUrl &secondaryUrl = QUrl(),
-                               DolphinTabWidget::NewTabPosition position = DolphinTabWidget::NewTabPosition::FollowSetting);
+                               DolphinTabWidget::NewTabPosition position = DolphinTabWidget::NewTabPosition::FollowSetting,
+                               bool loadingDeferred = false);
 
     /**
      * Opens each directory in \p dirs in a separate tab unless it is already open.
@@ -287,8 +290,16 @@ private:
      */
     const std::optional<const ViewIndex> viewShowingItem(const QUrl &item) const;
 
+    /**
+     * Loads the directories of the next restored tab that has not been
+     * activated yet. Is invoked by m_warmUpTimer if warming up the restored
+     * tabs is enabled.
+     */
+    void warmUpNextRestoredTab();
+
 private:
     QPointer<DolphinTabPage> m_lastViewedTab;
+    QTimer *m_warmUpTimer;
     QPointer<DolphinNavigatorsWidgetAction> m_navigatorsWidget;
 };
 
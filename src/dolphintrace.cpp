@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphintrace.h"
+
+#include "dolphintracedebug.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+
+namespace
+{
+/**
+ * Writes the spans to the file given by the environment variable
+ * DOLPHIN_TRACE_FILE. Spans might end in several threads.
+ */
+class TraceFile
+{
+public:
+    TraceFile()
+    {
+        m_timer.start();
+
+        const QString filePath = qEnvironmentVariable("DOLPHIN_TRACE_FILE");
+        if (filePath.isEmpty()) {
+            return;
+        }
+
+        m_file.setFileName(filePath);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(DolphinTrace) << "Cannot open the trace file" << filePath;
+        }
+    }
+
+    ~TraceFile()
+    {
+        if (m_file.isOpen()) {
+            m_file.write(m_eventCount > 0 ? "\n]\n" : "[]\n");
+        }
+    }
+
+    bool isOpen() const
+    {
+        return m_file.isOpen();
+    }
+
+    qint64 elapsed() const
+    {
+        return m_timer.nsecsElapsed();
+    }
+
+    void write(const char *name, qint64 start, qint64 duration, qint64 count)
+    {
+        // Complete event, the times are given in microseconds
+        QByteArray event;
+        event.reserve(192);
+        event += "{\"name\":\"";
+        event += name;
+        event += "\",\"cat\":\"dolphin\",\"ph\":\"X\",\"ts\":";
+        event += QByteArray::number(start / 1000.0, 'f', 3);
+        event += ",\"dur\":";
+        event += QByteArray::number(duration / 1000.0, 'f', 3);
+        event += ",\"pid\":";
+        event += QByteArray::number(QCoreApplication::applicationPid());
+        event += ",\"tid\":";
+        event += QByteArray::number(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+        if (count >= 0) {
+            event += ",\"args\":{\"count\":";
+            event += QByteArray::number(count);
+            event += '}';
+        }
+        event += '}';
+
+        QMutexLocker locker(&m_mutex);
+        m_file.write(m_eventCount > 0 ? ",\n" : "[\n");
+        m_file.write(event);
+        // Keep the trace usable if Dolphin crashes or gets killed
+        m_file.flush();
+        ++m_eventCount;
+    }
+
+private:
+    QElapsedTimer m_timer;
+    QMutex m_mutex;
+    QFile m_file;
+    int m_eventCount = 0;
+};
+
+Q_GLOBAL_STATIC(TraceFile, s_traceFile)
+}
+
+DolphinTraceSpan::DolphinTraceSpan(const char *name, qint64 count)
+    : m_name(name)
+    , m_count(count)
+    , m_start(isEnabled() ? s_traceFile->elapsed() : -1)
+{
+}
+
+DolphinTraceSpan::~DolphinTraceSpan()
+{
+    if (m_start < 0) {
+        return;
+    }
+
+    const qint64 duration = s_traceFile->elapsed() - m_start;
+    if (DolphinTrace().isDebugEnabled()) {
+        if (m_count >= 0) {
+            qCDebug(DolphinTrace).nospace() << m_name << ": " << duration / 1000000.0 << " ms for " << m_count << " items";
+        } else {
+            qCDebug(DolphinTrace).nospace() << m_name << ": " << duration / 1000000.0 << " ms";
+        }
+    }
+    if (s_traceFile->isOpen()) {
+        s_traceFile->write(m_name, m_start, duration, m_count);
+    }
+}
+
+void DolphinTraceSpan::setCount(qint64 count)
+{
+    m_count = count;
+}
+
+bool DolphinTraceSpan::isEnabled()
+{
+    return DolphinTrace().isDebugEnabled() || s_traceFile->isOpen();
+}
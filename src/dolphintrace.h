@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINTRACE_H
+#define DOLPHINTRACE_H
+
+#include "dolphin_export.h"
+
+#include <QtGlobal>
+
+/**
+ * @brief Measures the duration of a scope to diagnose performance issues.
+ *
+ * Tracing is disabled by default. It can be enabled at runtime without
+ * recompiling:
+ * - Enabling the debug output of the logging category org.kde.dolphin.trace,
+ *   e.g. by QT_LOGGING_RULES="org.kde.dolphin.trace.debug=true", logs the
+ *   duration of each span.
+ * - Setting the environment variable DOLPHIN_TRACE_FILE to a file path writes
+ *   the spans in the Chrome trace event format. The file can be opened with
+ *   https://ui.perfetto.dev or chrome://tracing.
+ *
+ * \code
+ * void KFileItemModel::resortAllItems()
+ * {
+ *     const DolphinTraceSpan span("KFileItemModel::resortAllItems", count());
+ *     ...
+ * }
+ * \endcode
+ */
+class DOLPHIN_EXPORT DolphinTraceSpan
+{
+public:
+    /**
+     * Starts the span.
+     * @param name  Name of the span. Must be valid until the span ends, usually
+     *              a string literal.
+     * @param count Number of processed items. Recorded with the span if not negative.
+     */
+    explicit DolphinTraceSpan(const char *name, qint64 count = -1);
+
+    /**
+     * Ends the span.
+     */
+    ~DolphinTraceSpan();
+
+    /**
+     * Sets the number of processed items if it is not known when starting the span.
+     */
+    void setCount(qint64 count);
+
+    /**
+     * @return True if spans are logged or written to a trace file.
+     */
+    static bool isEnabled();
+
+private:
+    const char *m_name;
+    qint64 m_count;
+    // Start time in nanoseconds, -1 if tracing is disabled
+    qint64 m_start;
+
+    Q_DISABLE_COPY(DolphinTraceSpan)
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinurlcompletion.h"
+
+#include "dolphinlocationindex.h"
+
+#include <QTimer>
+
+namespace
+{
+constexpr int MaxIndexCompletions = 50;
+
+// Delay in milliseconds before the file system is listed for a text
+// that does not match any known location
+constexpr int FileSystemCompletionDelay = 300;
+}
+
+DolphinUrlCompletion::DolphinUrlCompletion()
+    : KUrlCompletion(KUrlCompletion::DirCompletion)
+    , m_indexLocations()
+    , m_defaultOrder(order())
+    , m_fileSystemCompletionTimer(nullptr)
+    , m_fileSystemCompletionText()
+    , m_listedItems()
+{
+    m_fileSystemCompletionTimer = new QTimer(this);
+    m_fileSystemCompletionTimer->setSingleShot(true);
+    m_fileSystemCompletionTimer->setInterval(FileSystemCompletionDelay);
+    connect(m_fileSystemCompletionTimer, &QTimer::timeout, this, &DolphinUrlCompletion::completeFromFileSystem);
+}
+
+DolphinUrlCompletion::~DolphinUrlCompletion() = default;
+
+QString DolphinUrlCompletion::makeCompletion(const QString &text)
+{
+    m_fileSystemCompletionTimer->stop();
+
+    const QStringList locations = DolphinLocationIndex::instance().completions(text, MaxIndexCompletions);
+    if (locations.isEmpty()) {
+        m_fileSystemCompletionText = text;
+        m_fileSystemCompletionTimer->start();
+        return QString();
+    }
+
+    if (m_indexLocations.isEmpty()) {
+        // The items are the ones of KUrlCompletion. Remember them before
+        // they get replaced by the known locations.
+        stop();
+        m_listedItems = items();
+    }
+
+    // Only the known locations that match the current text are offered.
+    m_indexLocations = QSet<QString>(locations.begin(), locations.end());
+    setOrder(KCompletion::Insertion);
+    setItems(locations);
+    return KCompletion::makeCompletion(text);
+}
+
+void DolphinUrlCompletion::postProcessMatch(QString *match) const
+{
+    if (!m_indexLocations.contains(*match)) {
+        KUrlCompletion::postProcessMatch(match);
+    }
+}
+
+void DolphinUrlCompletion::postProcessMatches(QStringList *matches) const
+{
+    if (m_indexLocations.isEmpty()) {
+        KUrlCompletion::postProcessMatches(matches);
+        return;
+    }
+
+    QStringList indexMatches;
+    QStringList otherMatches;
+    for (const QString &match : std::as_const(*matches)) {
+        if (m_indexLocations.contains(match)) {
+            indexMatches.append(match);
+        } else {
+            otherMatches.append(match);
+        }
+    }
+    KUrlCompletion::postProcessMatches(&otherMatches);
+    *matches = indexMatches + otherMatches;
+}
+
+void DolphinUrlCompletion::postProcessMatches(KCompletionMatches *matches) const
+{
+    if (m_indexLocations.isEmpty()) {
+        KUrlCompletion::postProcessMatches(matches);
+        return;
+    }
+
+    KCompletionMatches indexMatches(false);
+    KCompletionMatches otherMatches(false);
+    for (const KSortableItem<QString> &match : std::as_const(*matches)) {
+        if (m_indexLocations.contains(match.value())) {
+            indexMatches.append(match);
+        } else {
+            otherMatches.append(match);
+        }
+    }
+    KUrlCompletion::postProcessMatches(&otherMatches);
+    indexMatches.append(otherMatches);
+    *matches = indexMatches;
+}
+
+void DolphinUrlCompletion::completeFromFileSystem()
+{
+    if (!m_indexLocations.isEmpty()) {
+        m_indexLocations.clear();
+        setItems(m_listedItems);
+        m_listedItems.clear();
+    }
+    setOrder(m_defaultOrder);
+
+    KUrlCompletion::makeCompletion(m_fileSystemCompletionText);
+}
+
+#include "moc_dolphinurlcompletion.cpp"
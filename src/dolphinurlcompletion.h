@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINURLCOMPLETION_H
+#define DOLPHINURLCOMPLETION_H
+
+#include <KUrlCompletion>
+
+#include <QSet>
+#include <QStringList>
+
+class QTimer;
+
+/**
+ * @brief Completes URLs in the editable location bar.
+ *
+ * The known locations from the DolphinLocationIndex are completed without
+ * accessing the file system. Only if no known location matches the text,
+ * the sub-directories are listed like by KUrlCompletion. The listing starts
+ * delayed, so that it is skipped while the user is still typing, as it might
+ * block or trigger a mount.
+ */
+class DolphinUrlCompletion : public KUrlCompletion
+{
+    Q_OBJECT
+
+public:
+    DolphinUrlCompletion();
+    ~DolphinUrlCompletion() override;
+
+    QString makeCompletion(const QString &text) override;
+
+protected:
+    void postProcessMatch(QString *match) const override;
+    void postProcessMatches(QStringList *matches) const override;
+    void postProcessMatches(KCompletionMatches *matches) const override;
+
+private Q_SLOTS:
+    /**
+     * Completes the last text passed to makeCompletion() by listing the
+     * file system. The result is emitted asynchronously by KUrlCompletion.
+     */
+    void completeFromFileSystem();
+
+private:
+    // Known locations that match the current text. KUrlCompletion accesses
+    // the file system when post-processing the matches, which is not required
+    // for them.
+    QSet<QString> m_indexLocations;
+    KCompletion::CompOrder m_defaultOrder;
+
+    QTimer *m_fileSystemCompletionTimer;
+    QString m_fileSystemCompletionText;
+
+    // Items of the last listing of KUrlCompletion. They are restored before
+    // KUrlCompletion is used again, as it reuses the items if the same
+    // directory is completed again.
+    QStringList m_listedItems;
+};
+
+#endif // DOLPHINURLCOMPLETION_H
@@ -9,6 +9,7 @@
 
 #include "dolphin_generalsettings.h"
 #include "dolphinplacesmodelsingleton.h"
+#include "dolphinurlcompletion.h"
 #include "dolphinurlnavigatorscontroller.h"
 #include "global.h"
 
@@ -34,6 +35,8 @@ DolphinUrlNavigator::DolphinUrlNavigator(const QUrl &url, QWidget *parent)
     setShowFullPath(settings->showFullPath());
     setHomeUrl(Dolphin::homeUrl());
     setPlacesSelectorVisible(DolphinUrlNavigatorsController::placesSelectorVisible());
+    editor()->setCompletionObject(new DolphinUrlCompletion());
+    editor()->setAutoDeleteCompletionObject(true);
     editor()->setCompletionMode(KCompletion::CompletionMode(settings->urlCompletionMode()));
     setWhatsThis(xi18nc("@info:whatsthis location bar",
                         "<para>This describes the location of the files and folders "
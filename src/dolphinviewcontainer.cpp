@@ -14,6 +14,7 @@
 #include "dolphin_generalsettings.h"
 #include "dolphin_iconsmodesettings.h"
 #include "dolphindebug.h"
+#include "dolphinlocationindex.h"
 #include "dolphinplacesmodelsingleton.h"
 #include "filterbar/filterbar.h"
 #include "global.h"
@@ -67,7 +68,7 @@ struct LayoutStructure {
 };
 constexpr LayoutStructure positionFor;
 
-DolphinViewContainer::DolphinViewContainer(const QUrl &url, QWidget *parent)
+DolphinViewContainer::DolphinViewContainer(const QUrl &url, QWidget *parent, bool loadingDeferred)
     : QWidget(parent)
     , m_topLayout(nullptr)
     , m_urlNavigator{new DolphinUrlNavigator(url)}
@@ -116,7 +117,7 @@ DolphinViewContainer::DolphinViewContainer(const QUrl &url, QWidget *parent)
     connect(m_filterBar, &FilterBar::focusViewRequest, this, &DolphinViewContainer::requestFocus);
 
     // Initialize the main view
-    m_view = new DolphinView(url, this);
+    m_view = new DolphinView(url, this, loadingDeferred);
     connect(m_view, &DolphinView::urlChanged, m_filterBar, &FilterBar::clearIfUnlocked);
     connect(m_view, &DolphinView::urlChanged, m_messageWidget, &KMessageWidget::hide);
     // m_urlNavigator stays in sync with m_view's location changes and
@@ -159,6 +160,9 @@ DolphinViewContainer::DolphinViewContainer(const QUrl &url, QWidget *parent)
     connect(m_view, &DolphinView::directorySortingProgress, m_statusBar, [this](int percent) {
         m_statusBar->showProgress(i18nc("@info:progress", "Sorting…"), percent);
     });
+    connect(m_view, &DolphinView::subtreeExpansionProgress, m_statusBar, [this](int percent) {
+        m_statusBar->showProgress(i18nc("@info:progress", "Expanding folders…"), percent);
+    });
     connect(m_statusBar, &DolphinStatusBar::stopPressed, this, &DolphinViewContainer::stopDirectoryLoading);
     connect(m_statusBar, &DolphinStatusBar::zoomLevelChanged, this, &DolphinViewContainer::slotStatusBarZoomLevelChanged);
     connect(m_statusBar, &DolphinStatusBar::showMessage, this, [this](const QString &message, KMessageWidget::MessageType messageType) {
@@ -902,6 +906,10 @@ void DolphinViewContainer::slotUrlNavigatorLocationChanged(const QUrl &url)
         m_view->setUrl(url);
         tryRestoreViewState();
 
+        if (!isSearchUrl(url)) {
+            DolphinLocationIndex::instance().addLocation(url, DolphinLocationIndex::VisitedLocation);
+        }
+
         if (m_grabFocusOnUrlChange && isActive()) {
             // When an URL has been entered, the view should get the focus.
             // The focus must be requested asynchronously, as changing the URL might create
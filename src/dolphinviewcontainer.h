@@ -64,7 +64,11 @@ class DolphinViewContainer : public QWidget
     Q_OBJECT
 
 public:
-    DolphinViewContainer(const QUrl &url, QWidget *parent);
+    /**
+     * @param loadingDeferred If true, the view does not load its directory
+     *                        until loading gets enabled. @see DolphinView::setLoadingDeferred()
+     */
+    DolphinViewContainer(const QUrl &url, QWidget *parent, bool loadingDeferred = false);
     ~DolphinViewContainer() override;
 
     /**
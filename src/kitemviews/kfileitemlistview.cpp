@@ -9,6 +9,7 @@
 #include "kfileitemlistwidget.h"
 #include "kfileitemmodel.h"
 #include "kfileitemmodelrolesupdater.h"
+#include "private/kitemlisticoncache.h"
 #include "private/kitemviewsutils.h"
 #include "private/kpixmapmodifier.h"
 
@@ -19,10 +20,9 @@
 #include <QIcon>
 #include <QMimeDatabase>
 #include <QPainter>
+#include <QSet>
 #include <QTimer>
 
-// #define KFILEITEMLISTVIEW_DEBUG
-
 namespace
 {
 // If the visible index range changes, KFileItemModelRolesUpdater is not
@@ -42,6 +42,7 @@ KFileItemListView::KFileItemListView(QGraphicsWidget *parent)
     , m_modelRolesUpdater(nullptr)
     , m_updateVisibleIndexRangeTimer(nullptr)
     , m_updateIconSizeTimer(nullptr)
+    , m_iconCachePrewarmPending(false)
 {
     setAcceptDrops(true);
 
@@ -277,6 +278,15 @@ void KFileItemListView::onStyleOptionChanged(const KItemListStyleOption &current
 {
     KStandardItemListView::onStyleOptionChanged(current, previous);
     triggerIconSizeUpdate();
+    if (current.iconSize != previous.iconSize) {
+        if (isTransactionActive()) {
+            // The item size and therefore the visible items are usually
+            // changed in the same transaction, see onTransactionEnd().
+            m_iconCachePrewarmPending = true;
+        } else {
+            prewarmIconCache();
+        }
+    }
 }
 
 void KFileItemListView::onSupportsItemExpandingChanged(bool supportsExpanding)
@@ -295,6 +305,11 @@ void KFileItemListView::onTransactionBegin()
 
 void KFileItemListView::onTransactionEnd()
 {
+    if (m_iconCachePrewarmPending) {
+        m_iconCachePrewarmPending = false;
+        prewarmIconCache();
+    }
+
     if (!m_modelRolesUpdater) {
         return;
     }
@@ -330,7 +345,11 @@ void KFileItemListView::updateSelectedWidgets()
 {
     const auto visibleWidgets = visibleItemListWidgets();
     for (KItemListWidget *widget : visibleWidgets) {
-        if (widget->isSelected()) {
+        if (widget->cacheMode() != QGraphicsItem::NoCache && !widget->isSelected()) {
+            // The alternate background depends on the focus as well, so the
+            // cached pixmaps of the unselected widgets must be repainted.
+            widget->update();
+        } else if (widget->isSelected()) {
             auto w = qobject_cast<KFileItemListWidget *>(widget);
             if (w) {
                 w->forceUpdate();
@@ -387,9 +406,34 @@ void KFileItemListView::updateVisibleIndexRange()
     const int count = lastVisibleIndex() - index + 1;
     m_modelRolesUpdater->setMaximumVisibleItems(maximumVisibleItems());
     m_modelRolesUpdater->setVisibleIndexRange(index, count);
+
+    // The model keeps the visible items in place while a large directory is loading
+    KFileItemModel *fileItemModel = static_cast<KFileItemModel *>(model());
+    fileItemModel->setMaximumVisibleItems(maximumVisibleItems());
+    fileItemModel->setVisibleIndexRange(index, count);
     m_modelRolesUpdater->setPaused(isTransactionActive());
 }
 
+void KFileItemListView::prewarmIconCache()
+{
+    if (!model() || model()->count() == 0) {
+        return;
+    }
+
+    // Load the icons of the visible items for the new size at once, so that each
+    // icon is looked up in the theme only once instead of by each widget.
+    QSet<QString> iconNames{QStringLiteral("unknown")};
+    const int lastIndex = lastVisibleIndex();
+    for (int i = std::max(firstVisibleIndex(), 0); i <= lastIndex; ++i) {
+        const QString iconName = model()->data(i).value("iconName").toString();
+        if (!iconName.isEmpty()) {
+            iconNames.insert(iconName);
+        }
+    }
+
+    KItemListIconCache::instance()->prewarm(iconNames.values(), availableIconSize().height(), KItemViewsUtils::devicePixelRatio(this));
+}
+
 void KFileItemListView::triggerIconSizeUpdate()
 {
     if (!model()) {
@@ -418,6 +462,7 @@ void KFileItemListView::updateIconSize()
     const int index = firstVisibleIndex();
     const int count = lastVisibleIndex() - index + 1;
     m_modelRolesUpdater->setVisibleIndexRange(index, count);
+    static_cast<KFileItemModel *>(model())->setVisibleIndexRange(index, count);
 
     m_modelRolesUpdater->setPaused(isTransactionActive());
 }
@@ -103,6 +103,12 @@ private Q_SLOTS:
     void updateIconSize();
 
 private:
+    /**
+     * Loads the icons of the visible items for the current icon size
+     * into the KItemListIconCache.
+     */
+    void prewarmIconCache();
+
     /**
      * Applies the roles defined by KItemListView::visibleRoles() to the
      * KFileItemModel and KFileItemModelRolesUpdater. As the model does not
@@ -125,6 +131,9 @@ private:
     QTimer *m_updateVisibleIndexRangeTimer;
     QTimer *m_updateIconSizeTimer;
 
+    // True if the icon size has been changed during a transaction, see prewarmIconCache()
+    bool m_iconCachePrewarmPending;
+
     friend class KFileItemListViewTest; // For unit testing
     friend class DolphinMainWindowTest; // For unit testing
 };
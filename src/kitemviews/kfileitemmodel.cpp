@@ -11,6 +11,7 @@
 #include "dolphin_contentdisplaysettings.h"
 #include "dolphin_generalsettings.h"
 #include "dolphindebug.h"
+#include "dolphintrace.h"
 #include "private/kfileitemmodelsortalgorithm.h"
 #include "views/draganddrophelper.h"
 
@@ -24,19 +25,58 @@
 #ifndef QT_NO_ACCESSIBILITY
 #include <QAccessible>
 #endif
-#include <QElapsedTimer>
 #include <QMimeData>
 #include <QMimeDatabase>
+#include <QReadWriteLock>
 #include <QRecursiveMutex>
 #include <QTimer>
 #include <QWidget>
+#include <QtConcurrentRun>
 #include <QtCore/qcompare.h>
 #include <algorithm>
+#include <vector>
 #include <klazylocalizedstring.h>
 
 Q_GLOBAL_STATIC(QRecursiveMutex, s_collatorMutex)
 
-// #define KFILEITEMMODEL_DEBUG
+// Serializes the parts of retrieveData() that are not reentrant, like the
+// user and group name lookups and the icon theme lookups
+Q_GLOBAL_STATIC(QMutex, s_retrieveDataMutex)
+
+namespace
+{
+// Minimum number of items for which prepareItemsForSorting() retrieves
+// the data on several threads
+constexpr int ParallelRetrieveDataThreshold = 1000;
+
+// While a directory is being loaded, the pending items are inserted at the latest after
+// MaximumUpdateInterval. If enough items to fill the view arrive before, they are inserted
+// into the empty model immediately. Afterwards, the pending items of such a large directory
+// are inserted periodically, starting with FirstUpdateInterval and doubling the interval up
+// to MaximumUpdateInterval, as merging them into a large model gets more expensive.
+// DefaultFirstBatchItemCount is used if the number of items that fit into the view is unknown.
+constexpr int DefaultFirstBatchItemCount = 500;
+constexpr int FirstUpdateInterval = 200;
+constexpr int MaximumUpdateInterval = 2000;
+
+// While the sorting of search results is deferred, only the first items are
+// ordered by their relevance, so that inserting results stays cheap.
+constexpr int SearchRelevanceItemCount = 50;
+
+// Minimum number of deleted items for which slotItemsDeleted() determines
+// their indexes by one pass over all items instead of looking up each item
+constexpr int BulkDeletionThreshold = 100;
+
+// IDs of the roles that are not part of KFileItemModel::RoleType,
+// see KFileItemModel::roleId()
+struct DynamicRoles {
+    QReadWriteLock lock;
+    QHash<QByteArray, int> ids;
+    QList<QByteArray> names;
+};
+}
+
+Q_GLOBAL_STATIC(DynamicRoles, s_dynamicRoles)
 
 namespace
 {
@@ -280,6 +320,16 @@ KFileItemModel::KFileItemModel(QObject *parent)
     , m_groups()
     , m_expandedDirs()
     , m_urlsToExpand()
+    , m_subtreeLevelUrls()
+    , m_subtreeUrlsToList()
+    , m_subtreeLevel(0)
+    , m_subtreeMaximumDepth(0)
+    , m_searchTerm()
+    , m_sortingDeferred(false)
+    , m_lastVisibleIndex(-1)
+    , m_maximumVisibleItems(0)
+    , m_loadingProgressively(false)
+    , m_resortAfterLoading(false)
 {
     m_collator.setNumericMode(true);
 
@@ -304,7 +354,8 @@ KFileItemModel::KFileItemModel(QObject *parent)
     connect(m_dirLister, &KCoreDirLister::jobError, this, &KFileItemModel::slotListerError);
     connect(m_dirLister, &KCoreDirLister::percent, this, &KFileItemModel::directoryLoadingProgress);
     connect(m_dirLister, &KCoreDirLister::redirection, this, &KFileItemModel::directoryRedirection);
-    connect(m_dirLister, &KCoreDirLister::listingDirCompleted, this, &KFileItemModel::slotCompleted);
+    connect(m_dirLister, &KCoreDirLister::listingDirCompleted, this, &KFileItemModel::slotListingDirCompleted);
+    connect(m_dirLister, &KCoreDirLister::listingDirCanceled, this, &KFileItemModel::slotListingDirCanceled);
 
     // Apply default roles that should be determined
     resetRoles();
@@ -319,9 +370,9 @@ KFileItemModel::KFileItemModel(QObject *parent)
     // For slow KIO-slaves like used for searching it makes sense to show results periodically even
     // before the completed() or canceled() signal has been emitted.
     m_maximumUpdateIntervalTimer = new QTimer(this);
-    m_maximumUpdateIntervalTimer->setInterval(2000);
+    m_maximumUpdateIntervalTimer->setInterval(MaximumUpdateInterval);
     m_maximumUpdateIntervalTimer->setSingleShot(true);
-    connect(m_maximumUpdateIntervalTimer, &QTimer::timeout, this, &KFileItemModel::dispatchPendingItemsToInsert);
+    connect(m_maximumUpdateIntervalTimer, &QTimer::timeout, this, &KFileItemModel::slotMaximumUpdateIntervalExceeded);
 
     // When changing the value of an item which represents the sort-role a resorting must be
     // triggered. Especially in combination with KFileItemModelRolesUpdater this might be done
@@ -347,6 +398,7 @@ KFileItemModel::~KFileItemModel()
 
 void KFileItemModel::loadDirectory(const QUrl &url)
 {
+    m_sortingDeferred = !m_searchTerm.isEmpty();
     m_dirLister->openUrl(url);
 }
 
@@ -359,6 +411,7 @@ void KFileItemModel::refreshDirectory(const QUrl &url)
         m_dirLister->openUrl(expandedDirs.value(), KDirLister::Reload);
     }
 
+    m_sortingDeferred = !m_searchTerm.isEmpty();
     m_dirLister->openUrl(url, KDirLister::Reload);
 
     Q_EMIT directoryRefreshing();
@@ -371,6 +424,8 @@ QUrl KFileItemModel::directory() const
 
 void KFileItemModel::cancelDirectoryLoading()
 {
+    // Canceling by the user also stops expanding a subtree, see slotListingDirCanceled()
+    resetSubtreeExpansion();
     m_dirLister->stop();
 }
 
@@ -383,25 +438,15 @@ SmallHash KFileItemModel::data(int index) const
 {
     if (index >= 0 && index < count()) {
         ItemData *data = m_itemData.at(index);
-        if (data->values.isEmpty()) {
-            data->values = retrieveData(data->item, data->parent);
-        } else if (data->values.count() <= 2 && data->values.value("isExpanded").toBool()) {
-            // Special case dealt by slotRefreshItems(), avoid losing the "isExpanded" and "expandedParentsCount" state when refreshing
-            // slotRefreshItems() makes sure folders keep the "isExpanded" and "expandedParentsCount" while clearing the remaining values
-            // so this special request of different behavior can be identified here.
-            bool hasExpandedParentsCount = false;
-            const int expandedParentsCount = data->values.value("expandedParentsCount").toInt(&hasExpandedParentsCount);
-
-            data->values = retrieveData(data->item, data->parent);
-            data->values.insert("isExpanded", true);
-            if (hasExpandedParentsCount) {
-                data->values.insert("expandedParentsCount", expandedParentsCount);
-            }
-        }
+        ensureValuesRetrieved(data);
 
-        SmallHash result = data->values;
+        SmallHash result;
+        result.reserve(data->values.count() + 1);
+        for (const auto &[role, value] : data->values) {
+            result.insert(roleName(role), value);
+        }
         // The url is not stored per item (it is derivable from the KFileItem); inject it here.
-        result.insert(sharedValue("url"), data->item.url());
+        result.insert(QByteArrayLiteral("url"), data->item.url());
         return result;
     }
     return SmallHash();
@@ -419,42 +464,84 @@ bool KFileItemModel::setData(int index, const SmallHash &values)
         return false;
     }
 
-    SmallHash currentValues = data(index);
+    const QSet<QByteArray> changedRoles = applyData(index, values);
+    if (changedRoles.isEmpty()) {
+        return false;
+    }
+
+    emitItemsChangedAndTriggerResorting(KItemRangeList() << KItemRange(index, 1), changedRoles);
+
+    return true;
+}
+
+bool KFileItemModel::setItemsData(const QHash<int, SmallHash> &itemsValues)
+{
+    QList<int> changedIndexes;
+    QSet<QByteArray> changedRoles;
+    for (auto it = itemsValues.constBegin(); it != itemsValues.constEnd(); ++it) {
+        const int index = it.key();
+        if (index < 0 || index >= count()) {
+            continue;
+        }
+
+        const QSet<QByteArray> roles = applyData(index, it.value());
+        if (!roles.isEmpty()) {
+            changedIndexes.append(index);
+            changedRoles.unite(roles);
+        }
+    }
+
+    if (changedIndexes.isEmpty()) {
+        return false;
+    }
+
+    std::sort(changedIndexes.begin(), changedIndexes.end());
+    emitItemsChangedAndTriggerResorting(KItemRangeList::fromSortedContainer(changedIndexes), changedRoles);
+
+    return true;
+}
+
+QSet<QByteArray> KFileItemModel::applyData(int index, const SmallHash &values)
+{
+    ItemData *itemData = m_itemData[index];
+    ensureValuesRetrieved(itemData);
+    RoleValues currentValues = itemData->values;
 
     // Determine which roles have been changed
     QSet<QByteArray> changedRoles;
     for (const auto &[key, value] : values) {
-        const QByteArray role = sharedValue(key);
-        if (currentValues[role] != value) {
-            currentValues[role] = value;
-            changedRoles.insert(role);
+        if (key == "url") {
+            // "url" is injected by data(), not stored per item.
+            if (itemData->item.url() != value.toUrl()) {
+                changedRoles.insert(key);
+            }
+            continue;
+        }
+
+        const int role = roleId(key);
+        if (currentValues.value(role) != value) {
+            currentValues.insert(role, value);
+            changedRoles.insert(key);
         }
     }
 
     if (changedRoles.isEmpty()) {
-        return false;
+        return changedRoles;
     }
 
     if (changedRoles.contains("text")) {
-        QUrl url = m_itemData[index]->item.url();
+        QUrl url = itemData->item.url();
         m_items.remove(url);
         url = url.adjusted(QUrl::RemoveFilename);
-        url.setPath(url.path() + currentValues["text"].toString());
-        m_itemData[index]->item.setUrl(url);
+        url.setPath(url.path() + currentValues.value(NameRole).toString());
+        itemData->item.setUrl(url);
         m_items.insert(url, index);
 
-        if (!changedRoles.contains("url")) {
-            changedRoles.insert("url");
-            currentValues["url"] = url;
-        }
+        changedRoles.insert("url");
     }
-    // "url" is injected by data(), not stored per item.
-    currentValues.remove(sharedValue("url"));
-    m_itemData[index]->values = currentValues;
-
-    emitItemsChangedAndTriggerResorting(KItemRangeList() << KItemRange(index, 1), changedRoles);
+    itemData->values = currentValues;
 
-    return true;
+    return changedRoles;
 }
 
 void KFileItemModel::setSortDirectoriesFirst(bool dirsFirst)
@@ -663,55 +750,154 @@ QString KFileItemModel::roleDescription(const QByteArray &role) const
 
 QList<QPair<int, QVariant>> KFileItemModel::groups() const
 {
+    if (m_sortingDeferred) {
+        // The items are not ordered by the group role yet.
+        return {};
+    }
+
     if (!m_itemData.isEmpty() && m_groups.isEmpty()) {
-#ifdef KFILEITEMMODEL_DEBUG
-        QElapsedTimer timer;
-        timer.start();
-#endif
-        switch (typeForRole(groupRole())) {
-        case NameRole:
-            m_groups = nameRoleGroups();
-            break;
-        case SizeRole:
-            m_groups = sizeRoleGroups();
-            break;
-        case ModificationTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::ModificationTime);
-            });
-            break;
-        case CreationTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::CreationTime);
-            });
-            break;
-        case AccessTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::AccessTime);
-            });
-            break;
-        case DeletionTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->values.value("deletiontime").toDateTime();
-            });
-            break;
-        case PermissionsRole:
-            m_groups = permissionRoleGroups();
-            break;
-        case RatingRole:
-            m_groups = ratingRoleGroups();
-            break;
-        default:
-            m_groups = genericStringRoleGroups(groupRole());
-            break;
+        const DolphinTraceSpan span("KFileItemModel::groups", count());
+        m_groups = computeGroups(0, count() - 1);
+    }
+
+    return m_groups;
+}
+
+QList<QPair<int, QVariant>> KFileItemModel::computeGroups(int firstIndex, int lastIndex) const
+{
+    switch (typeForRole(groupRole())) {
+    case NameRole:
+        return nameRoleGroups(firstIndex, lastIndex);
+    case SizeRole:
+        return sizeRoleGroups(firstIndex, lastIndex);
+    case ModificationTimeRole:
+        return timeRoleGroups(firstIndex, lastIndex, [](const ItemData *item) {
+            return item->item.time(KFileItem::ModificationTime);
+        });
+    case CreationTimeRole:
+        return timeRoleGroups(firstIndex, lastIndex, [](const ItemData *item) {
+            return item->item.time(KFileItem::CreationTime);
+        });
+    case AccessTimeRole:
+        return timeRoleGroups(firstIndex, lastIndex, [](const ItemData *item) {
+            return item->item.time(KFileItem::AccessTime);
+        });
+    case DeletionTimeRole:
+        return timeRoleGroups(firstIndex, lastIndex, [](const ItemData *item) {
+            return item->values.value(DeletionTimeRole).toDateTime();
+        });
+    case PermissionsRole:
+        return permissionRoleGroups(firstIndex, lastIndex);
+    case RatingRole:
+        return ratingRoleGroups(firstIndex, lastIndex);
+    default:
+        return genericStringRoleGroups(groupRole(), firstIndex, lastIndex);
+    }
+}
+
+void KFileItemModel::updateGroupsForInsertedItems(const KItemRangeList &itemRanges)
+{
+    if (m_groups.isEmpty()) {
+        // The groups have not been calculated yet or have been cleared.
+        return;
+    }
+
+    // Shift the indexes of the existing groups. The indexes of the
+    // item ranges refer to the items before the insertion.
+    int rangeIndex = 0;
+    int insertedCount = 0;
+    for (QPair<int, QVariant> &group : m_groups) {
+        while (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index <= group.first) {
+            insertedCount += itemRanges.at(rangeIndex).count;
+            ++rangeIndex;
         }
+        group.first += insertedCount;
+    }
 
-#ifdef KFILEITEMMODEL_DEBUG
-        qCDebug(DolphinDebug) << "[TIME] Calculating groups for" << count() << "items:" << timer.elapsed();
-#endif
+    insertedCount = 0;
+    for (const KItemRange &range : itemRanges) {
+        const int firstIndex = range.index + insertedCount;
+        updateGroupsInRange(firstIndex, firstIndex + range.count - 1);
+        insertedCount += range.count;
+    }
+}
+
+void KFileItemModel::updateGroupsForRemovedItems(const KItemRangeList &itemRanges)
+{
+    if (m_groups.isEmpty()) {
+        return;
     }
 
-    return m_groups;
+    if (m_itemData.isEmpty()) {
+        m_groups.clear();
+        return;
+    }
+
+    // Remove the groups of the removed items and shift the indexes of the
+    // remaining groups. The indexes of the item ranges refer to the items
+    // before the removal.
+    QList<QPair<int, QVariant>> groups;
+    groups.reserve(m_groups.count());
+    int rangeIndex = 0;
+    int removedCount = 0;
+    for (const QPair<int, QVariant> &group : std::as_const(m_groups)) {
+        while (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index + itemRanges.at(rangeIndex).count <= group.first) {
+            removedCount += itemRanges.at(rangeIndex).count;
+            ++rangeIndex;
+        }
+        if (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index <= group.first) {
+            // The first item of the group has been removed.
+            continue;
+        }
+        groups.append(qMakePair(group.first - removedCount, group.second));
+    }
+    m_groups = groups;
+
+    // The item behind each removed range has a new predecessor.
+    removedCount = 0;
+    for (const KItemRange &range : itemRanges) {
+        const int index = range.index - removedCount;
+        updateGroupsInRange(index, index - 1);
+        removedCount += range.count;
+    }
+}
+
+void KFileItemModel::updateGroupsInRange(int firstIndex, int lastIndex)
+{
+    const int maxIndex = count() - 1;
+
+    // Whether an item starts a new group only depends on the item
+    // and on the previous item that is no child-item.
+    int previousIndex = firstIndex - 1;
+    while (previousIndex >= 0 && isChildItem(previousIndex)) {
+        --previousIndex;
+    }
+    int nextIndex = lastIndex + 1;
+    while (nextIndex <= maxIndex && isChildItem(nextIndex)) {
+        ++nextIndex;
+    }
+
+    const int scanBegin = (previousIndex >= 0) ? previousIndex : firstIndex;
+    const int scanEnd = std::min(nextIndex, maxIndex);
+    if (scanBegin > scanEnd) {
+        return;
+    }
+
+    // Replace the groups that start behind the previous item by the updated groups.
+    const auto lessThanIndex = [](const QPair<int, QVariant> &group, int index) {
+        return group.first < index;
+    };
+    const auto begin = std::lower_bound(m_groups.begin(), m_groups.end(), previousIndex + 1, lessThanIndex);
+    const auto end = std::lower_bound(begin, m_groups.end(), scanEnd + 1, lessThanIndex);
+    int insertIndex = m_groups.erase(begin, end) - m_groups.begin();
+
+    const QList<QPair<int, QVariant>> groups = computeGroups(scanBegin, scanEnd);
+    for (const QPair<int, QVariant> &group : groups) {
+        if (group.first > previousIndex) {
+            m_groups.insert(insertIndex, group);
+            ++insertIndex;
+        }
+    }
 }
 
 KFileItem KFileItemModel::fileItem(int index) const
@@ -877,8 +1063,10 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
         return false;
     }
 
+    static const int previouslyExpandedChildrenRole = roleId("previouslyExpandedChildren");
+
     SmallHash values;
-    values.insert(sharedValue("isExpanded"), expanded);
+    values.insert(QByteArrayLiteral("isExpanded"), expanded);
     if (!setData(index, values)) {
         return false;
     }
@@ -890,7 +1078,7 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
         m_expandedDirs.insert(targetUrl, url);
         m_dirLister->openUrl(url, KDirLister::Keep);
 
-        const QVariantList previouslyExpandedChildren = m_itemData.at(index)->values.value("previouslyExpandedChildren").value<QVariantList>();
+        const QVariantList previouslyExpandedChildren = m_itemData.at(index)->values.value(previouslyExpandedChildrenRole).value<QVariantList>();
         for (const QVariant &var : previouslyExpandedChildren) {
             m_urlsToExpand.insert(var.toUrl());
         }
@@ -920,7 +1108,7 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
         int childIndex = firstChildIndex;
         while (childIndex < itemCount && expandedParentsCount(childIndex) > parentLevel) {
             ItemData *itemData = m_itemData.at(childIndex);
-            if (itemData->values.value("isExpanded").toBool()) {
+            if (itemData->values.value(IsExpandedRole).toBool()) {
                 const QUrl targetUrl = itemData->item.targetUrl();
                 const QUrl url = itemData->item.url();
                 m_expandedDirs.remove(targetUrl);
@@ -935,16 +1123,28 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
         removeFilteredChildren(KItemRangeList() << KItemRange(index, 1 + childrenCount));
         removeItems(KItemRangeList() << KItemRange(firstChildIndex, childrenCount), DeleteItemData);
 
-        m_itemData.at(index)->values.insert("previouslyExpandedChildren", expandedChildren);
+        m_itemData.at(index)->values.insert(previouslyExpandedChildrenRole, expandedChildren);
     }
 
     return true;
 }
 
+bool KFileItemModel::expandSubtree(int index, int maximumDepth)
+{
+    if (maximumDepth < 1 || !isExpandable(index)) {
+        return false;
+    }
+
+    resetSubtreeExpansion();
+    m_subtreeMaximumDepth = maximumDepth;
+    expandSubtreeLevel({fileItem(index).url()});
+    return true;
+}
+
 bool KFileItemModel::isExpanded(int index) const
 {
     if (index >= 0 && index < count()) {
-        return m_itemData.at(index)->values.value("isExpanded").toBool();
+        return m_itemData.at(index)->values.value(IsExpandedRole).toBool();
     }
     return false;
 }
@@ -1113,8 +1313,42 @@ QStringList KFileItemModel::excludeMimeTypeFilter() const
     return m_filter.excludeMimeTypes();
 }
 
+void KFileItemModel::setSearchTerm(const QString &searchTerm)
+{
+    m_searchTerm = searchTerm;
+}
+
+QString KFileItemModel::searchTerm() const
+{
+    return m_searchTerm;
+}
+
+bool KFileItemModel::isSortingDeferred() const
+{
+    return m_sortingDeferred;
+}
+
+void KFileItemModel::sortDeferredItems()
+{
+    if (m_sortingDeferred) {
+        resortAllItems();
+    }
+}
+
+void KFileItemModel::setVisibleIndexRange(int index, int count)
+{
+    m_lastVisibleIndex = (count > 0) ? index + count - 1 : -1;
+}
+
+void KFileItemModel::setMaximumVisibleItems(int count)
+{
+    m_maximumVisibleItems = count;
+}
+
 void KFileItemModel::applyFilters()
 {
+    const DolphinTraceSpan span("KFileItemModel::applyFilters", m_itemData.count() + m_filteredItems.count());
+
     // ===STEP 1===
     // Check which previously shown items from m_itemData must now get
     // hidden and hence moved from m_itemData into m_filteredItems.
@@ -1330,17 +1564,16 @@ void KFileItemModel::resortAllItems()
 {
     m_resortAllItemsTimer->stop();
 
+    // Changing the sorting ends the arrival order of search results.
+    m_sortingDeferred = false;
+    m_resortAfterLoading = false;
+
     const int itemCount = count();
     if (itemCount <= 0) {
         return;
     }
 
-#ifdef KFILEITEMMODEL_DEBUG
-    QElapsedTimer timer;
-    timer.start();
-    qCDebug(DolphinDebug) << "===========================================================";
-    qCDebug(DolphinDebug) << "Resorting" << itemCount << "items";
-#endif
+    const DolphinTraceSpan span("KFileItemModel::resortAllItems", itemCount);
 
     // Remember the order of the current URLs so
     // that it can be determined which indexes have
@@ -1397,16 +1630,15 @@ void KFileItemModel::resortAllItems()
             Q_EMIT groupsChanged();
         }
     }
-
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] Resorting of" << itemCount << "items:" << timer.elapsed();
-#endif
 }
 
 void KFileItemModel::slotCompleted()
 {
     m_maximumUpdateIntervalTimer->stop();
+    m_maximumUpdateIntervalTimer->setInterval(MaximumUpdateInterval);
     dispatchPendingItemsToInsert();
+    finishProgressiveLoading();
+    sortDeferredItems();
 
     if (!m_urlsToExpand.isEmpty()) {
         // Try to find a URL that can be expanded.
@@ -1435,10 +1667,43 @@ void KFileItemModel::slotCompleted()
     Q_EMIT directoryLoadingCompleted();
 }
 
+void KFileItemModel::slotListingDirCompleted(const QUrl &url)
+{
+    if (!m_subtreeUrlsToList.remove(url)) {
+        slotCompleted();
+        return;
+    }
+
+    if (m_subtreeUrlsToList.isEmpty()) {
+        // Inserts the items of all directories of the level at once
+        slotCompleted();
+        finishSubtreeLevel();
+        return;
+    }
+
+    const int levelCount = m_subtreeLevelUrls.count();
+    const qreal levelProgress = qreal(levelCount - m_subtreeUrlsToList.count()) / levelCount;
+    Q_EMIT subtreeExpansionProgress(static_cast<int>(100 * (m_subtreeLevel - 1 + levelProgress) / m_subtreeMaximumDepth));
+}
+
+void KFileItemModel::slotListingDirCanceled(const QUrl &url)
+{
+    if (m_subtreeUrlsToList.contains(url)) {
+        // The listing of a directory of the subtree has failed, e.g. because the
+        // directory is not readable. Go on with the other directories of the level.
+        slotListingDirCompleted(url);
+    }
+}
+
 void KFileItemModel::slotCanceled()
 {
+    resetSubtreeExpansion();
+
     m_maximumUpdateIntervalTimer->stop();
+    m_maximumUpdateIntervalTimer->setInterval(MaximumUpdateInterval);
     dispatchPendingItemsToInsert();
+    finishProgressiveLoading();
+    sortDeferredItems();
 
     Q_EMIT directoryLoadingCanceled();
 }
@@ -1460,9 +1725,11 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
             return;
         }
 
-        if (directoryUrl != directory()) {
+        if (directoryUrl != directory() && !m_subtreeUrlsToList.contains(directoryUrl)) {
             // To be able to compare whether the new items may be inserted as children
             // of a parent item the pending items must be added to the model first.
+            // This is not necessary for the directories of an expanded subtree, whose
+            // parents have been inserted before the listing of the level has been started.
             dispatchPendingItemsToInsert();
         }
 
@@ -1470,7 +1737,7 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
         // they got collapsed again with KFileItemModel::setExpanded(false). So it must be
         // checked whether the parent for new items is still expanded.
         const int parentIndex = index(parentUrl);
-        if (parentIndex >= 0 && !m_itemData[parentIndex]->values.value("isExpanded").toBool()) {
+        if (parentIndex >= 0 && !m_itemData[parentIndex]->values.value(IsExpandedRole).toBool()) {
             // The parent is not expanded.
             return;
         }
@@ -1505,7 +1772,15 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
         }
     }
 
-    if (!m_maximumUpdateIntervalTimer->isActive()) {
+    const int firstBatchItemCount = (m_maximumVisibleItems > 0) ? m_maximumVisibleItems : DefaultFirstBatchItemCount;
+    if (m_itemData.isEmpty() && m_pendingItemsToInsert.count() >= firstBatchItemCount) {
+        // Show the first items of a large directory immediately. The remaining
+        // items are merged into the model step by step behind the visible items.
+        m_maximumUpdateIntervalTimer->stop();
+        m_maximumUpdateIntervalTimer->setInterval(FirstUpdateInterval);
+        dispatchPendingItemsToInsert();
+        m_loadingProgressively = true;
+    } else if (!m_maximumUpdateIntervalTimer->isActive()) {
         // Assure that items get dispatched if no completed() or canceled() signal is
         // emitted during the maximum update interval.
         m_maximumUpdateIntervalTimer->start();
@@ -1556,43 +1831,75 @@ void KFileItemModel::slotItemsDeleted(const KFileItemList &items)
 
     QVector<int> indexesToRemove;
     indexesToRemove.reserve(items.count());
-    KFileItemList dirsChanged;
+    QSet<QUrl> dirsChangedUrls;
 
     const auto currentDir = directory();
-
     for (const KFileItem &item : items) {
         if (item.url() == currentDir) {
             Q_EMIT currentDirectoryRemoved();
             return;
         }
 
-        const int indexForItem = index(item);
-        if (indexForItem >= 0) {
-            indexesToRemove.append(indexForItem);
-        } else {
-            // Probably the item has been filtered.
-            QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.find(item);
-            if (it != m_filteredItems.end()) {
-                delete it.value();
-                m_filteredItems.erase(it);
+        dirsChangedUrls.insert(item.url().adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash));
+    }
+
+    // Items that are not part of the model have probably been filtered.
+    KFileItemList filteredItems;
+
+    if (items.count() >= BulkDeletionThreshold) {
+        // Looking up each item would fill m_items with the URLs of all items,
+        // although removeItems() clears it afterwards. Compare all items with
+        // the deleted URLs instead, which results in sorted indexes.
+        QHash<QUrl, int> deletedUrls;
+        deletedUrls.reserve(items.count());
+        for (int i = 0; i < items.count(); ++i) {
+            deletedUrls.insert(items.at(i).url().adjusted(QUrl::StripTrailingSlash), i);
+        }
+
+        const int itemCount = m_itemData.count();
+        for (int index = 0; index < itemCount && !deletedUrls.isEmpty(); ++index) {
+            if (deletedUrls.remove(m_itemData.at(index)->item.url())) {
+                indexesToRemove.append(index);
             }
         }
 
-        QUrl parentUrl = item.url().adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash);
-        if (dirsChanged.findByUrl(parentUrl).isNull()) {
-            dirsChanged << KFileItem(parentUrl);
+        for (const int i : std::as_const(deletedUrls)) {
+            filteredItems.append(items.at(i));
+        }
+    } else {
+        for (const KFileItem &item : items) {
+            const int indexForItem = index(item);
+            if (indexForItem >= 0) {
+                indexesToRemove.append(indexForItem);
+            } else {
+                filteredItems.append(item);
+            }
         }
+
+        std::sort(indexesToRemove.begin(), indexesToRemove.end());
     }
 
-    std::sort(indexesToRemove.begin(), indexesToRemove.end());
+    for (const KFileItem &item : std::as_const(filteredItems)) {
+        QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.find(item);
+        if (it != m_filteredItems.end()) {
+            delete it.value();
+            m_filteredItems.erase(it);
+        }
+    }
 
     if (m_requestRole[ExpandedParentsCountRole] && !m_expandedDirs.isEmpty()) {
         // Assure that removing a parent item also results in removing all children
         QVector<int> indexesToRemoveWithChildren;
         indexesToRemoveWithChildren.reserve(m_itemData.count());
 
+        // As the indexes are sorted, the children of an item are directly behind it. Children
+        // that are deleted themselves have been added already together with their parent.
         const int itemCount = m_itemData.count();
+        int childrenEnd = 0;
         for (int index : std::as_const(indexesToRemove)) {
+            if (index < childrenEnd) {
+                continue;
+            }
             indexesToRemoveWithChildren.append(index);
 
             const int parentLevel = expandedParentsCount(index);
@@ -1601,6 +1908,7 @@ void KFileItemModel::slotItemsDeleted(const KFileItemList &items)
                 indexesToRemoveWithChildren.append(childIndex);
                 ++childIndex;
             }
+            childrenEnd = childIndex;
         }
 
         indexesToRemove = indexesToRemoveWithChildren;
@@ -1618,23 +1926,30 @@ void KFileItemModel::slotItemsDeleted(const KFileItemList &items)
     // so removeItems() will check m_filteredItems to differentiate which is which.
     removeItems(itemRanges, filteredParentsCount > 0 ? DeleteItemDataIfUnfiltered : DeleteItemData);
 
+    KFileItemList dirsChanged;
+    dirsChanged.reserve(dirsChangedUrls.count());
+    for (const QUrl &url : std::as_const(dirsChangedUrls)) {
+        dirsChanged << KFileItem(url);
+    }
     Q_EMIT fileItemsChanged(dirsChanged);
 }
 
 void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items)
 {
     Q_ASSERT(!items.isEmpty());
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "Refreshing" << items.count() << "items";
-#endif
+    const DolphinTraceSpan span("KFileItemModel::slotRefreshItems", items.count());
 
     // Get the indexes of all items that have been refreshed
     QList<int> indexes;
     indexes.reserve(items.count());
 
-    QSet<QByteArray> changedRoles;
+    QSet<int> changedRoleIds;
     KFileItemList changedFiles;
 
+    // Visible items that must be updated by the view, which excludes
+    // items where only properties have been changed that are not shown.
+    KFileItemList updatedFiles;
+
     // Contains the indexes of the currently visible items
     // that should get hidden and hence moved to m_filteredItems.
     QVector<int> newFilteredIndexes;
@@ -1657,25 +1972,38 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
             // Keep old values as long as possible if they could not retrieved synchronously yet.
             // The update of the values will be done asynchronously by KFileItemModelRolesUpdater.
             ItemData *const itemData = m_itemData.at(indexForItem);
-            const SmallHash newData = retrieveData(newItem, itemData->parent);
+            const RoleValues newData = retrieveData(newItem, itemData->parent);
+            bool valuesChanged = false;
             for (const auto &[role, value] : newData) {
                 if (itemData->values.value(role) != value) {
                     itemData->values.insert(role, value);
-                    changedRoles.insert(role);
+                    changedRoleIds.insert(role);
+                    valuesChanged = true;
                 }
             }
 
-            m_items.remove(oldItem.url());
-            // We must maintain m_items consistent with m_itemData for now, this very loop is using it.
-            // We leave it to be cleared by removeItems() later, when m_itemData actually gets updated.
-            m_items.insert(newItem.url(), indexForItem);
+            const bool urlChanged = (oldItem.url() != newItem.url());
+            if (urlChanged) {
+                m_items.remove(oldItem.url());
+                // We must maintain m_items consistent with m_itemData for now, this very loop is using it.
+                // We leave it to be cleared by removeItems() later, when m_itemData actually gets updated.
+                m_items.insert(newItem.url(), indexForItem);
+            }
             if (newItemMatchesFilter
-                || (itemData->values.value("isExpanded").toBool()
+                || (itemData->values.value(IsExpandedRole).toBool()
                     && (indexForItem + 1 < m_itemData.count() && m_itemData.at(indexForItem + 1)->parent == itemData))) {
                 // We are lenient with expanded folders that originally had visible children.
                 // If they become childless now they will be caught by filterChildlessParents()
                 changedFiles.append(newItem);
-                indexes.append(indexForItem);
+
+                // If only properties that are not shown have been changed, e.g. the permissions
+                // or the access time, neither the view nor KFileItemModelRolesUpdater need to
+                // update the item. A changed size or modification time might require a new preview.
+                if (valuesChanged || urlChanged || oldItem.size() != newItem.size()
+                    || oldItem.time(KFileItem::ModificationTime) != newItem.time(KFileItem::ModificationTime) || oldItem.overlays() != newItem.overlays()) {
+                    updatedFiles.append(newItem);
+                    indexes.append(indexForItem);
+                }
             } else {
                 newFilteredIndexes.append(indexForItem);
                 m_filteredItems.insert(newItem, itemData);
@@ -1691,14 +2019,14 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
                 // 'values' and re-populate it the next time it is requested via data(int).
                 // Before clearing, we must remember if it was expanded and the expanded parents count,
                 // otherwise these states would be lost. The data() method will deal with this special case.
-                const bool isExpanded = itemData->values.value("isExpanded").toBool();
+                const bool isExpanded = itemData->values.value(IsExpandedRole).toBool();
                 bool hasExpandedParentsCount = false;
-                const int expandedParentsCount = itemData->values.value("expandedParentsCount").toInt(&hasExpandedParentsCount);
+                const int expandedParentsCount = itemData->values.value(ExpandedParentsCountRole).toInt(&hasExpandedParentsCount);
                 itemData->values.clear();
                 if (isExpanded) {
-                    itemData->values.insert("isExpanded", true);
+                    itemData->values.insert(IsExpandedRole, true);
                     if (hasExpandedParentsCount) {
-                        itemData->values.insert("expandedParentsCount", expandedParentsCount);
+                        itemData->values.insert(ExpandedParentsCountRole, expandedParentsCount);
                     }
                 }
 
@@ -1754,6 +2082,9 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
     // If the changed items have been created recently, they might not be in m_items yet.
     // In that case, the list 'indexes' might be empty.
     if (indexes.isEmpty()) {
+        if (!changedFiles.isEmpty()) {
+            Q_EMIT fileItemsChanged(changedFiles);
+        }
         return;
     }
 
@@ -1761,9 +2092,9 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
         // The original indexes have changed and are now worthless since items were removed and/or inserted.
         indexes.clear();
         // m_items is not yet rebuilt at this point, so we use our own means to resolve the new indexes.
-        const QSet<const KFileItem> changedFilesSet(changedFiles.cbegin(), changedFiles.cend());
+        const QSet<const KFileItem> updatedFilesSet(updatedFiles.cbegin(), updatedFiles.cend());
         for (int i = 0; i < m_itemData.count(); i++) {
-            if (changedFilesSet.contains(m_itemData.at(i)->item)) {
+            if (updatedFilesSet.contains(m_itemData.at(i)->item)) {
                 indexes.append(i);
             }
         }
@@ -1771,6 +2102,12 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
         std::sort(indexes.begin(), indexes.end());
     }
 
+    QSet<QByteArray> changedRoles;
+    changedRoles.reserve(changedRoleIds.count());
+    for (const int role : std::as_const(changedRoleIds)) {
+        changedRoles.insert(roleName(role));
+    }
+
     // Extract the item-ranges out of the changed indexes
     const KItemRangeList itemRangeList = KItemRangeList::fromSortedContainer(indexes);
     emitItemsChangedAndTriggerResorting(itemRangeList, changedRoles);
@@ -1780,16 +2117,15 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
 
 void KFileItemModel::slotClear()
 {
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "Clearing all items";
-#endif
-
     qDeleteAll(m_filteredItems);
     m_filteredItems.clear();
     m_groups.clear();
 
     m_maximumUpdateIntervalTimer->stop();
+    m_maximumUpdateIntervalTimer->setInterval(MaximumUpdateInterval);
     m_resortAllItemsTimer->stop();
+    m_loadingProgressively = false;
+    m_resortAfterLoading = false;
 
     qDeleteAll(m_pendingItemsToInsert);
     m_pendingItemsToInsert.clear();
@@ -1803,6 +2139,7 @@ void KFileItemModel::slotClear()
     }
 
     m_expandedDirs.clear();
+    resetSubtreeExpansion();
 }
 
 void KFileItemModel::slotSortingChoiceChanged()
@@ -1811,6 +2148,29 @@ void KFileItemModel::slotSortingChoiceChanged()
     resortAllItems();
 }
 
+void KFileItemModel::slotMaximumUpdateIntervalExceeded()
+{
+    if (!m_subtreeUrlsToList.isEmpty()) {
+        // The items of a level of an expanded subtree are inserted at once
+        // after all directories of the level have been listed.
+        return;
+    }
+
+    dispatchPendingItemsToInsert();
+
+    // Only the directories whose first items have been shown early are updated
+    // with a growing interval, otherwise the interval is MaximumUpdateInterval.
+    m_maximumUpdateIntervalTimer->setInterval(std::min(2 * m_maximumUpdateIntervalTimer->interval(), MaximumUpdateInterval));
+}
+
+void KFileItemModel::finishProgressiveLoading()
+{
+    m_loadingProgressively = false;
+    if (m_resortAfterLoading) {
+        resortAllItems();
+    }
+}
+
 void KFileItemModel::dispatchPendingItemsToInsert()
 {
     if (!m_pendingItemsToInsert.isEmpty()) {
@@ -1819,21 +2179,98 @@ void KFileItemModel::dispatchPendingItemsToInsert()
     }
 }
 
+void KFileItemModel::expandSubtreeLevel(const QList<QUrl> &urls)
+{
+    ++m_subtreeLevel;
+    m_subtreeLevelUrls = urls;
+    m_subtreeUrlsToList.clear();
+
+    for (const QUrl &url : urls) {
+        const QUrl dirUrl = url.adjusted(QUrl::StripTrailingSlash);
+        m_subtreeUrlsToList.insert(dirUrl);
+
+        // Directories that have been expanded already are not listed again,
+        // but their children are part of the next level.
+        const int index = this->index(url);
+        if (index < 0 || !setExpanded(index, true)) {
+            m_subtreeUrlsToList.remove(dirUrl);
+        }
+    }
+
+    if (m_subtreeUrlsToList.isEmpty()) {
+        finishSubtreeLevel();
+    }
+}
+
+void KFileItemModel::finishSubtreeLevel()
+{
+    QList<QUrl> childUrls;
+    if (m_subtreeLevel < m_subtreeMaximumDepth) {
+        for (const QUrl &url : std::as_const(m_subtreeLevelUrls)) {
+            const int parentIndex = index(url);
+            if (!isExpanded(parentIndex)) {
+                continue;
+            }
+
+            const int childLevel = expandedParentsCount(parentIndex) + 1;
+            const int itemCount = count();
+            for (int childIndex = parentIndex + 1; childIndex < itemCount; ++childIndex) {
+                const int level = expandedParentsCount(childIndex);
+                if (level < childLevel) {
+                    break;
+                }
+                if (level == childLevel && isExpandable(childIndex)) {
+                    childUrls.append(m_itemData.at(childIndex)->item.url());
+                }
+            }
+        }
+    }
+
+    if (childUrls.isEmpty()) {
+        resetSubtreeExpansion();
+    } else {
+        Q_EMIT subtreeExpansionProgress(100 * m_subtreeLevel / m_subtreeMaximumDepth);
+        expandSubtreeLevel(childUrls);
+    }
+}
+
+void KFileItemModel::resetSubtreeExpansion()
+{
+    if (m_subtreeMaximumDepth > 0) {
+        m_subtreeLevelUrls.clear();
+        m_subtreeUrlsToList.clear();
+        m_subtreeLevel = 0;
+        m_subtreeMaximumDepth = 0;
+        Q_EMIT subtreeExpansionProgress(100);
+    }
+}
+
 void KFileItemModel::insertItems(QList<ItemData *> &newItems)
 {
     if (newItems.isEmpty()) {
         return;
     }
 
-#ifdef KFILEITEMMODEL_DEBUG
-    QElapsedTimer timer;
-    timer.start();
-    qCDebug(DolphinDebug) << "===========================================================";
-    qCDebug(DolphinDebug) << "Inserting" << newItems.count() << "items";
-#endif
+    const DolphinTraceSpan span("KFileItemModel::insertItems", newItems.count());
 
-    m_groups.clear();
-    prepareItemsForSorting(newItems);
+    {
+        const DolphinTraceSpan prepareSpan("KFileItemModel::prepareItemsForSorting", newItems.count());
+        prepareItemsForSorting(newItems);
+    }
+
+    if (m_sortingDeferred) {
+        const bool hasExpandedChildren = std::any_of(newItems.cbegin(), newItems.cend(), [](const ItemData *itemData) {
+            return itemData->parent != nullptr;
+        });
+        if (!hasExpandedChildren) {
+            insertSearchResults(newItems);
+            return;
+        }
+
+        // The children of expanded directories must be placed below their
+        // parents, which requires the items to be sorted.
+        resortAllItems();
+    }
 
     // Natural sorting of items can be very slow. However, it becomes much faster
     // if the input sequence is already mostly sorted. Therefore, we first sort
@@ -1843,29 +2280,42 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
             parallelMergeSort(newItems.begin(), newItems.end(), nameLessThan, QThread::idealThreadCount());
         } else if (isRoleValueNatural(m_sortRole)) {
             auto lambdaLessThan = [&](const KFileItemModel::ItemData *a, const KFileItemModel::ItemData *b) {
-                const QByteArray role = roleForType(m_sortRole);
-                return a->values.value(role).toString() < b->values.value(role).toString();
+                return a->values.value(m_sortRole).toString() < b->values.value(m_sortRole).toString();
             };
             parallelMergeSort(newItems.begin(), newItems.end(), lambdaLessThan, QThread::idealThreadCount());
         }
     }
 
-    sort(newItems.begin(), newItems.end());
-
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] Sorting:" << timer.elapsed();
-#endif
+    {
+        const DolphinTraceSpan sortSpan("KFileItemModel::sort", newItems.count());
+        sort(newItems.begin(), newItems.end());
+    }
 
     KItemRangeList itemRanges;
     const int existingItemCount = m_itemData.count();
     const int newItemCount = newItems.count();
     const int totalItemCount = existingItemCount + newItemCount;
 
+    // While a large directory is loading, the items up to the last visible
+    // one keep their positions. New items that belong before them are
+    // inserted behind them until the loading has been completed.
+    int keptItemCount = 0;
+    if (m_loadingProgressively && existingItemCount > 0) {
+        const bool hasExpandedChildren = std::any_of(newItems.cbegin(), newItems.cend(), [](const ItemData *itemData) {
+            return itemData->parent != nullptr;
+        });
+        if (!hasExpandedChildren) {
+            const int firstBatchItemCount = (m_maximumVisibleItems > 0) ? m_maximumVisibleItems : DefaultFirstBatchItemCount;
+            keptItemCount = qMin(existingItemCount, qMax(m_lastVisibleIndex + 1, firstBatchItemCount));
+        }
+    }
+
     if (existingItemCount == 0) {
         // Optimization for the common special case that there are no
         // items in the model yet. Happens, e.g., when entering a folder.
         m_itemData = newItems;
         itemRanges << KItemRange(0, newItemCount);
+        m_groups.clear();
     } else {
         m_itemData.reserve(totalItemCount);
         for (int i = existingItemCount; i < totalItemCount; ++i) {
@@ -1882,7 +2332,7 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
 
         while (sourceIndexNewItems >= 0) {
             ItemData *newItem = newItems.at(sourceIndexNewItems);
-            if (sourceIndexExistingItems >= 0 && lessThan(newItem, m_itemData.at(sourceIndexExistingItems), m_collator)) {
+            if (sourceIndexExistingItems >= keptItemCount && lessThan(newItem, m_itemData.at(sourceIndexExistingItems), m_collator)) {
                 // Move an existing item to its new position. If any new items
                 // are behind it, push the item range to itemRanges.
                 if (rangeCount > 0) {
@@ -1908,6 +2358,12 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
 
         // Note that itemRanges is still sorted in reverse order.
         std::reverse(itemRanges.begin(), itemRanges.end());
+
+        if (keptItemCount > 0 && lessThan(m_itemData.at(keptItemCount), m_itemData.at(keptItemCount - 1), m_collator)) {
+            m_resortAfterLoading = true;
+        }
+
+        updateGroupsForInsertedItems(itemRanges);
     }
 
     // The indexes in m_items are not correct anymore. Therefore, we clear m_items.
@@ -1915,10 +2371,115 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
     m_items.clear();
 
     Q_EMIT itemsInserted(itemRanges);
+}
 
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] Inserting of" << newItems.count() << "items:" << timer.elapsed();
-#endif
+void KFileItemModel::insertSearchResults(const QList<ItemData *> &newItems)
+{
+    const int existingItemCount = m_itemData.count();
+    const int relevantItemCount = qMin(existingItemCount, SearchRelevanceItemCount);
+
+    QList<int> existingRelevances;
+    existingRelevances.reserve(relevantItemCount);
+    for (int i = 0; i < relevantItemCount; ++i) {
+        existingRelevances.append(searchRelevance(m_itemData.at(i)));
+    }
+
+    // Order the new items by their relevance. Items with the same
+    // relevance keep the order of their arrival.
+    QList<QPair<int, ItemData *>> candidates;
+    candidates.reserve(newItems.count());
+    for (ItemData *itemData : newItems) {
+        candidates.append(qMakePair(searchRelevance(itemData), itemData));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const QPair<int, ItemData *> &a, const QPair<int, ItemData *> &b) {
+        return a.first > b.first;
+    });
+
+    // Merge the candidates into the first SearchRelevanceItemCount items. The
+    // first value of each pair is the index of the existing item that the
+    // new item is inserted before.
+    QList<QPair<int, ItemData *>> relevantItems;
+    int existingIndex = 0;
+    int candidateIndex = 0;
+    for (int position = 0; position < SearchRelevanceItemCount && candidateIndex < candidates.count(); ++position) {
+        const QPair<int, ItemData *> &candidate = candidates.at(candidateIndex);
+        if (existingIndex < relevantItemCount && existingRelevances.at(existingIndex) >= candidate.first) {
+            ++existingIndex;
+        } else {
+            relevantItems.append(qMakePair(existingIndex, candidate.second));
+            ++candidateIndex;
+        }
+    }
+
+    QSet<const ItemData *> insertedItems;
+    insertedItems.reserve(relevantItems.count());
+
+    QList<ItemData *> itemData;
+    itemData.reserve(existingItemCount + newItems.count());
+    KItemRangeList itemRanges;
+    int sourceIndex = 0;
+    for (const auto &[index, newItem] : std::as_const(relevantItems)) {
+        while (sourceIndex < index) {
+            itemData.append(m_itemData.at(sourceIndex));
+            ++sourceIndex;
+        }
+        itemData.append(newItem);
+        insertedItems.insert(newItem);
+
+        if (!itemRanges.isEmpty() && itemRanges.last().index == index) {
+            ++itemRanges.last().count;
+        } else {
+            itemRanges << KItemRange(index, 1);
+        }
+    }
+    while (sourceIndex < existingItemCount) {
+        itemData.append(m_itemData.at(sourceIndex));
+        ++sourceIndex;
+    }
+
+    // The other items are appended in the order of their arrival.
+    const int appendedItemCount = newItems.count() - relevantItems.count();
+    if (appendedItemCount > 0) {
+        for (ItemData *newItem : newItems) {
+            if (!insertedItems.contains(newItem)) {
+                itemData.append(newItem);
+            }
+        }
+
+        if (!itemRanges.isEmpty() && itemRanges.last().index == existingItemCount) {
+            itemRanges.last().count += appendedItemCount;
+        } else {
+            itemRanges << KItemRange(existingItemCount, appendedItemCount);
+        }
+    }
+
+    m_itemData = itemData;
+    m_groups.clear();
+    m_items.clear();
+
+    Q_EMIT itemsInserted(itemRanges);
+}
+
+int KFileItemModel::searchRelevance(const ItemData *item) const
+{
+    const QString name = item->item.text();
+    const int matchIndex = name.indexOf(m_searchTerm, 0, Qt::CaseInsensitive);
+    if (matchIndex < 0) {
+        return 0;
+    }
+
+    if (matchIndex == 0) {
+        return name.size() == m_searchTerm.size() ? 4 : 3;
+    }
+
+    // Check whether the term occurs at the start of a word, like "report" in "annual-report.pdf"
+    for (int index = matchIndex; index > 0; index = name.indexOf(m_searchTerm, index + 1, Qt::CaseInsensitive)) {
+        if (!name.at(index - 1).isLetterOrNumber()) {
+            return 2;
+        }
+    }
+
+    return 1;
 }
 
 void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBehavior behavior)
@@ -1927,8 +2488,6 @@ void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBe
         return;
     }
 
-    m_groups.clear();
-
     // Step 1: Remove the items from m_itemData, and free the ItemData.
     int removedItemsCount = 0;
     for (const KItemRange &range : itemRanges) {
@@ -1963,6 +2522,8 @@ void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBe
 
     m_itemData.erase(m_itemData.end() - removedItemsCount, m_itemData.end());
 
+    updateGroupsForRemovedItems(itemRanges);
+
     // The indexes in m_items are not correct anymore. Therefore, we clear m_items.
     // It will be re-populated with the updated indices if index(const QUrl&) is called.
     m_items.clear();
@@ -1972,12 +2533,9 @@ void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBe
 
 QList<KFileItemModel::ItemData *> KFileItemModel::createItemDataList(const QUrl &parentUrl, const KFileItemList &items) const
 {
-    if (m_sortRole == TypeRole || typeForRole(rawGroupRole()) == TypeRole) {
-        // Try to resolve the MIME-types synchronously to prevent a reordering of
-        // the items when sorting by type (per default MIME-types are resolved
-        // asynchronously by KFileItemModelRolesUpdater).
-        determineMimeTypes(items, 200);
-    }
+    // Note that the MIME-types are not determined here: sorting and grouping by
+    // type use the extension-based guess (see retrieveData()), and the final
+    // MIME-types are resolved asynchronously by KFileItemModelRolesUpdater.
 
     // We search for the parent in m_itemData and then in m_filteredItems if necessary
     const int parentIndex = index(parentUrl);
@@ -2007,46 +2565,67 @@ void KFileItemModel::prepareItemsForSorting(QList<ItemData *> &itemDataList)
     case PathRole:
     case FolderRole:
     case DeletionTimeRole:
-        // These roles can be determined with retrieveData, and they have to be stored
-        // in the QHash "values" for the sorting.
-        for (ItemData *itemData : std::as_const(itemDataList)) {
-            if (itemData->values.isEmpty()) {
-                itemData->values = retrieveData(itemData->item, itemData->parent);
-            }
-        }
-        break;
-
     case TypeRole:
-        // At least store the data including the file type for items with known MIME type.
-        for (ItemData *itemData : std::as_const(itemDataList)) {
-            if (itemData->values.isEmpty()) {
-                const KFileItem item = itemData->item;
-                if (item.isDir() || item.isMimeTypeKnown()) {
-                    itemData->values = retrieveData(itemData->item, itemData->parent);
-                }
-            }
-        }
-        break;
+        // These roles can be determined with retrieveData, and they have to be stored
+        // in the "values" for the sorting. For the TypeRole, retrieveData only
+        // guesses the type from the file name if the MIME-type is not known yet.
+        retrieveMissingData(itemDataList);
+        return;
 
     default:
         // The other roles are either resolved by KFileItemModelRolesUpdater
         // (this includes the SizeRole for directories), or they do not need
-        // to be stored in the QHash "values" for sorting because the data can
+        // to be stored in the "values" for sorting because the data can
         // be retrieved directly from the KFileItem (NameRole, SizeRole for files,
         // DateRole).
         break;
     }
 
-    if (typeForRole(rawGroupRole()) == TypeRole && m_sortRole != TypeRole) {
-        for (ItemData *itemData : std::as_const(itemDataList)) {
-            if (itemData->values.isEmpty()) {
-                const KFileItem &item = itemData->item;
-                if (item.isDir() || item.isMimeTypeKnown()) {
-                    itemData->values = retrieveData(itemData->item, itemData->parent);
-                }
-            }
+    if (typeForRole(rawGroupRole()) == TypeRole) {
+        retrieveMissingData(itemDataList);
+    }
+}
+
+void KFileItemModel::retrieveMissingData(const QList<ItemData *> &itemDataList) const
+{
+    QList<ItemData *> items;
+    for (ItemData *itemData : itemDataList) {
+        if (itemData->values.isEmpty()) {
+            items.append(itemData);
         }
     }
+
+    const int itemCount = items.count();
+    const int threadCount = QThread::idealThreadCount();
+    if (itemCount < ParallelRetrieveDataThreshold || threadCount <= 1) {
+        for (ItemData *itemData : std::as_const(items)) {
+            itemData->values = retrieveData(itemData->item, itemData->parent);
+        }
+        return;
+    }
+
+    // The threads only read the items and their parents and write the values into
+    // pre-allocated slots, which are assigned to the items once all threads are done.
+    std::vector<RoleValues> values(itemCount);
+    const auto retrieveRange = [this, &items, &values](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            values[i] = retrieveData(items.at(i)->item, items.at(i)->parent);
+        }
+    };
+
+    const int chunkSize = (itemCount + threadCount - 1) / threadCount;
+    QList<QFuture<void>> futures;
+    for (int begin = chunkSize; begin < itemCount; begin += chunkSize) {
+        futures.append(QtConcurrent::run(retrieveRange, begin, std::min(begin + chunkSize, itemCount)));
+    }
+    retrieveRange(0, std::min(chunkSize, itemCount));
+    for (QFuture<void> &future : futures) {
+        future.waitForFinished();
+    }
+
+    for (int i = 0; i < itemCount; ++i) {
+        items.at(i)->values = std::move(values[i]);
+    }
 }
 
 int KFileItemModel::expandedParentsCount(const ItemData *data)
@@ -2056,8 +2635,8 @@ int KFileItemModel::expandedParentsCount(const ItemData *data)
     const ItemData *parent = data->parent;
     if (parent) {
         if (parent->parent) {
-            Q_ASSERT(parent->values.contains("expandedParentsCount"));
-            return parent->values.value("expandedParentsCount").toInt() + 1;
+            Q_ASSERT(parent->values.contains(ExpandedParentsCountRole));
+            return parent->values.value(ExpandedParentsCountRole).toInt() + 1;
         } else {
             return 1;
         }
@@ -2099,6 +2678,11 @@ void KFileItemModel::emitItemsChangedAndTriggerResorting(const KItemRangeList &i
 {
     Q_EMIT itemsChanged(itemRanges, changedRoles);
 
+    if (m_sortingDeferred) {
+        // The items get sorted when the search has been completed.
+        return;
+    }
+
     // Trigger a resorting if necessary. Note that this can happen even if the sort
     // role has not changed at all because the file name can be used as a fallback.
     if (changedRoles.contains(sortRole()) || changedRoles.contains(roleForType(NameRole))
@@ -2154,10 +2738,12 @@ void KFileItemModel::resetRoles()
     }
 }
 
-KFileItemModel::RoleType KFileItemModel::typeForRole(const QByteArray &role) const
+KFileItemModel::RoleType KFileItemModel::typeForRole(const QByteArray &role)
 {
-    static QHash<QByteArray, RoleType> roles;
-    if (roles.isEmpty()) {
+    // The hash is initialized only once, which is thread-safe.
+    static const QHash<QByteArray, RoleType> roles = [] {
+        QHash<QByteArray, RoleType> roles;
+
         // Insert user visible roles that can be accessed with
         // KFileItemModel::roleInformation()
         int count = 0;
@@ -2176,15 +2762,18 @@ KFileItemModel::RoleType KFileItemModel::typeForRole(const QByteArray &role) con
         roles.insert("expandedParentsCount", ExpandedParentsCountRole);
 
         Q_ASSERT(roles.count() == RolesCount);
-    }
+        return roles;
+    }();
 
     return roles.value(role, NoRole);
 }
 
-QByteArray KFileItemModel::roleForType(RoleType roleType) const
+QByteArray KFileItemModel::roleForType(RoleType roleType)
 {
-    static QHash<RoleType, QByteArray> roles;
-    if (roles.isEmpty()) {
+    // The hash is initialized only once, which is thread-safe.
+    static const QHash<RoleType, QByteArray> roles = [] {
+        QHash<RoleType, QByteArray> roles;
+
         // Insert user visible roles that can be accessed with
         // KFileItemModel::roleInformation()
         int count = 0;
@@ -2203,44 +2792,104 @@ QByteArray KFileItemModel::roleForType(RoleType roleType) const
         roles.insert(ExpandedParentsCountRole, "expandedParentsCount");
 
         Q_ASSERT(roles.count() == RolesCount);
-    };
+        return roles;
+    }();
 
     return roles.value(roleType);
 }
 
-SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *parent) const
+int KFileItemModel::roleId(const QByteArray &role)
+{
+    const RoleType roleType = typeForRole(role);
+    if (roleType != NoRole || role.isEmpty()) {
+        return roleType;
+    }
+
+    DynamicRoles *dynamicRoles = s_dynamicRoles();
+    {
+        QReadLocker locker(&dynamicRoles->lock);
+        const auto it = dynamicRoles->ids.constFind(role);
+        if (it != dynamicRoles->ids.constEnd()) {
+            return *it;
+        }
+    }
+
+    QWriteLocker locker(&dynamicRoles->lock);
+    const auto it = dynamicRoles->ids.constFind(role);
+    if (it != dynamicRoles->ids.constEnd()) {
+        return *it;
+    }
+    const int id = RolesCount + dynamicRoles->names.count();
+    dynamicRoles->ids.insert(role, id);
+    dynamicRoles->names.append(role);
+    return id;
+}
+
+QByteArray KFileItemModel::roleName(int id)
 {
+    if (id < RolesCount) {
+        return roleForType(static_cast<RoleType>(id));
+    }
+
+    DynamicRoles *dynamicRoles = s_dynamicRoles();
+    QReadLocker locker(&dynamicRoles->lock);
+    return dynamicRoles->names.value(id - RolesCount);
+}
+
+void KFileItemModel::ensureValuesRetrieved(ItemData *data) const
+{
+    if (data->values.isEmpty()) {
+        data->values = retrieveData(data->item, data->parent);
+    } else if (data->values.count() <= 2 && data->values.value(IsExpandedRole).toBool()) {
+        // Special case dealt by slotRefreshItems(), avoid losing the "isExpanded" and "expandedParentsCount" state when refreshing
+        // slotRefreshItems() makes sure folders keep the "isExpanded" and "expandedParentsCount" while clearing the remaining values
+        // so this special request of different behavior can be identified here.
+        bool hasExpandedParentsCount = false;
+        const int expandedParentsCount = data->values.value(ExpandedParentsCountRole).toInt(&hasExpandedParentsCount);
+
+        data->values = retrieveData(data->item, data->parent);
+        data->values.insert(IsExpandedRole, true);
+        if (hasExpandedParentsCount) {
+            data->values.insert(ExpandedParentsCountRole, expandedParentsCount);
+        }
+    }
+}
+
+KFileItemModel::RoleValues KFileItemModel::retrieveData(const KFileItem &item, const ItemData *parent) const
+{
+    static const int iconNameRole = roleId("iconName");
+
     // It is important to insert only roles that are fast to retrieve. E.g.
     // KFileItem::iconName() can be very expensive if the MIME-type is unknown
     // and hence will be retrieved asynchronously by KFileItemModelRolesUpdater.
-    SmallHash data;
+    RoleValues data;
     data.reserve(m_roles.count());
 
     const bool isDir = item.isDir();
     if (m_requestRole[IsDirRole] && isDir) {
-        data.insert(sharedValue("isDir"), true);
+        data.insert(IsDirRole, true);
     }
 
     if (m_requestRole[IsLinkRole] && item.isLink()) {
-        data.insert(sharedValue("isLink"), true);
+        data.insert(IsLinkRole, true);
     }
 
     if (m_requestRole[IsHiddenRole]) {
         // all "temporary" file types are identified by glob, currentMimeType is therefore enough.
-        data.insert(sharedValue("isHidden"), item.isHidden() || item.currentMimeType().name() == QStringLiteral("application/x-trash"));
+        data.insert(IsHiddenRole, item.isHidden() || item.currentMimeType().name() == QStringLiteral("application/x-trash"));
     }
 
     if (m_requestRole[NameRole]) {
-        data.insert(sharedValue("text"), item.text());
+        data.insert(NameRole, item.text());
     }
 
     if (m_requestRole[ExtensionRole] && !isDir) {
         // TODO KF6 use KFileItem::suffix 464722
-        data.insert(sharedValue("extension"), QFileInfo(item.name()).suffix());
+        data.insert(ExtensionRole, QFileInfo(item.name()).suffix());
     }
 
     if (m_requestRole[SizeRole] && !isDir) {
-        data.insert(sharedValue("size"), item.size());
+        data.insert(SizeRole, item.size());
     }
 
     if (m_requestRole[ModificationTimeRole]) {
@@ -2248,7 +2897,7 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         // having several thousands of items. Instead read the raw number from UDSEntry directly
         // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
         const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
-        data.insert(sharedValue("modificationtime"), dateTime);
+        data.insert(ModificationTimeRole, dateTime);
     }
 
     if (m_requestRole[CreationTimeRole]) {
@@ -2256,7 +2905,7 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         // having several thousands of items. Instead read the raw number from UDSEntry directly
         // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
         const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_CREATION_TIME, -1);
-        data.insert(sharedValue("creationtime"), dateTime);
+        data.insert(CreationTimeRole, dateTime);
     }
 
     if (m_requestRole[AccessTimeRole]) {
@@ -2264,19 +2913,21 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         // having several thousands of items. Instead read the raw number from UDSEntry directly
         // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
         const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_ACCESS_TIME, -1);
-        data.insert(sharedValue("accesstime"), dateTime);
+        data.insert(AccessTimeRole, dateTime);
     }
 
     if (m_requestRole[PermissionsRole]) {
-        data.insert(sharedValue("permissions"), QVariantList() << item.permissionsString() << item.permissions());
+        data.insert(PermissionsRole, QVariantList() << item.permissionsString() << item.permissions());
     }
 
     if (m_requestRole[OwnerRole]) {
-        data.insert(sharedValue("owner"), item.user());
+        QMutexLocker locker(s_retrieveDataMutex());
+        data.insert(OwnerRole, item.user());
     }
 
     if (m_requestRole[GroupRole]) {
-        data.insert(sharedValue("group"), item.group());
+        QMutexLocker locker(s_retrieveDataMutex());
+        data.insert(GroupRole, item.group());
     }
 
     if (m_requestRole[DestinationRole]) {
@@ -2284,7 +2935,7 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         if (destination.isEmpty()) {
             destination = QLatin1Char('-');
         }
-        data.insert(sharedValue("destination"), destination);
+        data.insert(DestinationRole, destination);
     }
 
     if (m_requestRole[PathRole]) {
@@ -2294,10 +2945,7 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         } else {
             // For performance reasons cache the home-path in a static QString
             // (see QDir::homePath() for more details)
-            static QString homePath;
-            if (homePath.isEmpty()) {
-                homePath = QDir::homePath();
-            }
+            static const QString homePath = QDir::homePath();
 
             path = item.localPath();
             if (path.startsWith(homePath)) {
@@ -2307,14 +2955,14 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
 
         const int index = path.lastIndexOf(item.text());
         path = path.mid(0, index - 1);
-        data.insert(sharedValue("path"), path);
+        data.insert(PathRole, path);
     }
 
     if (m_requestRole[FolderRole]) {
         QUrl parentUrl =
             (item.url().scheme() == QLatin1String("trash")) ? QUrl::fromLocalFile(item.entry().stringValue(KIO::UDSEntry::UDS_EXTRA)) : item.targetUrl();
         QString folderName = parentUrl.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).fileName();
-        data.insert(sharedValue("folder"), folderName);
+        data.insert(FolderRole, folderName);
     }
 
     if (m_requestRole[DeletionTimeRole]) {
@@ -2322,39 +2970,49 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
         if (item.url().scheme() == QLatin1String("trash")) {
             deletionTime = QDateTime::fromString(item.entry().stringValue(KIO::UDSEntry::UDS_EXTRA + 1), Qt::ISODate);
         }
-        data.insert(sharedValue("deletiontime"), deletionTime);
+        data.insert(DeletionTimeRole, deletionTime);
     }
 
     if (m_requestRole[IsExpandableRole] && isDir) {
-        data.insert(sharedValue("isExpandable"), true);
+        data.insert(IsExpandableRole, true);
     }
 
     if (m_requestRole[ExpandedParentsCountRole]) {
         if (parent) {
             const int level = expandedParentsCount(parent) + 1;
-            data.insert(sharedValue("expandedParentsCount"), level);
+            data.insert(ExpandedParentsCountRole, level);
         }
     }
 
     if (item.isMimeTypeKnown()) {
+        QMutexLocker locker(s_retrieveDataMutex());
         const QString iconName = item.iconName();
+        locker.unlock();
         if (!iconName.isEmpty()) {
-            data.insert(sharedValue("iconName"), iconName);
+            data.insert(iconNameRole, iconName);
         }
 
         if (m_requestRole[TypeRole]) {
-            data.insert(sharedValue("type"), item.mimeComment());
+            data.insert(TypeRole, item.mimeComment());
+        }
+    } else if (m_requestRole[TypeRole]) {
+        if (isDir) {
+            static const QString folderMimeType = item.mimeComment();
+            data.insert(TypeRole, folderMimeType);
+        } else {
+            // KDirLister delivers the items with delayed MIME-types, so KFileItem::mimeComment()
+            // only matches the file name against the known extensions without reading the
+            // file. The guess gets refined by KFileItemModelRolesUpdater once the item
+            // becomes interesting for the view.
+            data.insert(TypeRole, item.mimeComment());
         }
-    } else if (m_requestRole[TypeRole] && isDir) {
-        static const QString folderMimeType = item.mimeComment();
-        data.insert(sharedValue("type"), folderMimeType);
     }
 
     if (m_requestRole[RatingRole] && item.isLocalFile()) {
         KFileMetaData::UserMetaData md(item.localPath());
         const int rating = md.rating();
         if (rating > 0) {
-            data.insert(sharedValue("rating"), rating);
+            data.insert(RatingRole, rating);
         }
     }
 
@@ -2363,15 +3021,16 @@ SmallHash KFileItemModel::retrieveData(const KFileItem &item, const ItemData *pa
 
 QString KFileItemModel::groupKeyForItem(const ItemData *item, const QByteArray &role) const
 {
-    switch (typeForRole(role)) {
+    const int id = roleId(role);
+    switch (id) {
     case ModificationTimeRole:
     case CreationTimeRole:
     case AccessTimeRole:
-        return QDateTime::fromSecsSinceEpoch(item->values.value(role).toLongLong()).date().toString(Qt::ISODate);
+        return QDateTime::fromSecsSinceEpoch(item->values.value(id).toLongLong()).date().toString(Qt::ISODate);
     case DeletionTimeRole:
-        return item->values.value("deletiontime").toDateTime().date().toString(Qt::ISODate);
+        return item->values.value(DeletionTimeRole).toDateTime().date().toString(Qt::ISODate);
     default:
-        return item->values.value(role).toString();
+        return item->values.value(id).toString();
     }
 }
 
@@ -2488,8 +3147,9 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
         if (ContentDisplaySettings::directorySizeMode() == ContentDisplaySettings::EnumDirectorySizeMode::ContentCount && itemA.isDir()) {
             // folders first then
             // items A and B are folders thanks to lessThan checks
-            auto valueA = a->values.value("count");
-            auto valueB = b->values.value("count");
+            static const int countRole = roleId("count");
+            auto valueA = a->values.value(countRole);
+            auto valueB = b->values.value(countRole);
             if (valueA.isNull()) {
                 if (!valueB.isNull()) {
                     return -1;
@@ -2508,13 +3168,13 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
 
         KIO::filesize_t sizeA = 0;
         if (itemA.isDir()) {
-            sizeA = a->values.value("size").toULongLong();
+            sizeA = a->values.value(SizeRole).toULongLong();
         } else {
             sizeA = itemA.size();
         }
         KIO::filesize_t sizeB = 0;
         if (itemB.isDir()) {
-            sizeB = b->values.value("size").toULongLong();
+            sizeB = b->values.value(SizeRole).toULongLong();
         } else {
             sizeB = itemB.size();
         }
@@ -2560,8 +3220,8 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
     }
 
     case DeletionTimeRole: {
-        const QDateTime dateTimeA = a->values.value("deletiontime").toDateTime();
-        const QDateTime dateTimeB = b->values.value("deletiontime").toDateTime();
+        const QDateTime dateTimeA = a->values.value(DeletionTimeRole).toDateTime();
+        const QDateTime dateTimeB = b->values.value(DeletionTimeRole).toDateTime();
         if (dateTimeA < dateTimeB) {
             return -1;
         } else if (dateTimeA > dateTimeB) {
@@ -2579,14 +3239,13 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
     case LineCountRole:
     case TrackRole:
     case ReleaseYearRole: {
-        result = a->values.value(roleForType(m_sortRole)).toInt() - b->values.value(roleForType(m_sortRole)).toInt();
+        result = a->values.value(m_sortRole).toInt() - b->values.value(m_sortRole).toInt();
         break;
     }
 
     case DimensionsRole: {
-        const QByteArray role = roleForType(m_sortRole);
-        const QSize dimensionsA = a->values.value(role).toSize();
-        const QSize dimensionsB = b->values.value(role).toSize();
+        const QSize dimensionsA = a->values.value(m_sortRole).toSize();
+        const QSize dimensionsB = b->values.value(m_sortRole).toSize();
 
         if (dimensionsA.width() == dimensionsB.width()) {
             result = dimensionsA.height() - dimensionsB.height();
@@ -2597,9 +3256,8 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
     }
 
     default: {
-        const QByteArray role = roleForType(m_sortRole);
-        const QString roleValueA = a->values.value(role).toString();
-        const QString roleValueB = b->values.value(role).toString();
+        const QString roleValueA = a->values.value(m_sortRole).toString();
+        const QString roleValueB = b->values.value(m_sortRole).toString();
         if (!roleValueA.isEmpty() && roleValueB.isEmpty()) {
             return -1;
         } else if (roleValueA.isEmpty() && !roleValueB.isEmpty()) {
@@ -2666,16 +3324,19 @@ int KFileItemModel::stringCompare(const QString &a, const QString &b, const QCol
     return QString::compare(a, b, Qt::CaseSensitive);
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
+    // Finding the group of a character requires locale-aware comparisons,
+    // so it is done only once per distinct first character.
+    QHash<QChar, QString> groupValueForChar;
+
     QString groupValue;
     QChar firstChar;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2689,65 +3350,73 @@ QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups() const
         }
 
         if (firstChar != newFirstChar) {
-            QString newGroupValue;
-            if (newFirstChar.isLetter()) {
-                if (m_collator.compare(newFirstChar, QChar(QLatin1Char('A'))) >= 0 && m_collator.compare(newFirstChar, QChar(QLatin1Char('Z'))) <= 0) {
-                    // WARNING! Symbols based on latin 'Z' like 'Z' with acute are treated wrong as non Latin and put in a new group.
-
-                    // Try to find a matching group in the range 'A' to 'Z'.
-                    static std::vector<QChar> lettersAtoZ;
-                    lettersAtoZ.reserve('Z' - 'A' + 1);
-                    if (lettersAtoZ.empty()) {
-                        for (char c = 'A'; c <= 'Z'; ++c) {
-                            lettersAtoZ.push_back(QLatin1Char(c));
-                        }
-                    }
+            auto it = groupValueForChar.find(newFirstChar);
+            if (it == groupValueForChar.end()) {
+                it = groupValueForChar.insert(newFirstChar, nameRoleGroupValue(newFirstChar));
+            }
 
-                    auto localeAwareLessThan = [this](QChar c1, QChar c2) -> bool {
-                        return m_collator.compare(c1, c2) < 0;
-                    };
+            if (*it != groupValue) {
+                groupValue = *it;
+                groups.append(QPair<int, QVariant>(i, groupValue));
+            }
 
-                    std::vector<QChar>::iterator it = std::lower_bound(lettersAtoZ.begin(), lettersAtoZ.end(), newFirstChar, localeAwareLessThan);
-                    if (it != lettersAtoZ.end()) {
-                        if (localeAwareLessThan(newFirstChar, *it)) {
-                            // newFirstChar belongs to the group preceding *it.
-                            // Example: for an umlaut 'A' in the German locale, *it would be 'B' now.
-                            --it;
-                        }
-                        newGroupValue = *it;
-                    }
+            firstChar = newFirstChar;
+        }
+    }
+    return groups;
+}
 
-                } else {
-                    // Symbols from non Latin-based scripts
-                    newGroupValue = newFirstChar;
+QString KFileItemModel::nameRoleGroupValue(QChar firstChar) const
+{
+    if (firstChar.isLetter()) {
+        if (m_collator.compare(firstChar, QChar(QLatin1Char('A'))) >= 0 && m_collator.compare(firstChar, QChar(QLatin1Char('Z'))) <= 0) {
+            // WARNING! Symbols based on latin 'Z' like 'Z' with acute are treated wrong as non Latin and put in a new group.
+
+            // Try to find a matching group in the range 'A' to 'Z'.
+            static std::vector<QChar> lettersAtoZ;
+            if (lettersAtoZ.empty()) {
+                lettersAtoZ.reserve('Z' - 'A' + 1);
+                for (char c = 'A'; c <= 'Z'; ++c) {
+                    lettersAtoZ.push_back(QLatin1Char(c));
                 }
-            } else if (newFirstChar >= QLatin1Char('0') && newFirstChar <= QLatin1Char('9')) {
-                // Apply group '0 - 9' for any name that starts with a digit
-                newGroupValue = i18nc("@title:group Groups that start with a digit", "0 - 9");
-            } else {
-                newGroupValue = i18nc("@title:group", "Others");
             }
 
-            if (newGroupValue != groupValue) {
-                groupValue = newGroupValue;
-                groups.append(QPair<int, QVariant>(i, newGroupValue));
-            }
+            auto localeAwareLessThan = [this](QChar c1, QChar c2) -> bool {
+                return m_collator.compare(c1, c2) < 0;
+            };
 
-            firstChar = newFirstChar;
+            std::vector<QChar>::iterator it = std::lower_bound(lettersAtoZ.begin(), lettersAtoZ.end(), firstChar, localeAwareLessThan);
+            if (it != lettersAtoZ.end()) {
+                if (localeAwareLessThan(firstChar, *it)) {
+                    // firstChar belongs to the group preceding *it.
+                    // Example: for an umlaut 'A' in the German locale, *it would be 'B' now.
+                    --it;
+                }
+                return *it;
+            }
+            return QString();
         }
+
+        // Symbols from non Latin-based scripts
+        return firstChar;
     }
-    return groups;
+
+    if (firstChar >= QLatin1Char('0') && firstChar <= QLatin1Char('9')) {
+        // Apply group '0 - 9' for any name that starts with a digit
+        return i18nc("@title:group Groups that start with a digit", "0 - 9");
+    }
+
+    return i18nc("@title:group", "Others");
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2759,7 +3428,7 @@ QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups() const
             if (ContentDisplaySettings::directorySizeMode() == ContentDisplaySettings::EnumDirectorySizeMode::ContentCount || m_sortDirsFirst) {
                 newGroupValue = i18nc("@title:group Size", "Folders");
             } else {
-                fileSize = m_itemData.at(i)->values.value("size").toULongLong();
+                fileSize = m_itemData.at(i)->values.value(SizeRole).toULongLong();
             }
         }
 
@@ -2782,228 +3451,298 @@ QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb) const
+namespace
 {
-    Q_ASSERT(!m_itemData.isEmpty());
-
-    const int maxIndex = count() - 1;
-    QList<QPair<int, QVariant>> groups;
-
-    const QDate currentDate = QDate::currentDate();
+/**
+ * @return A number that is equal for two dates if and only if both dates get
+ *         the same label in timeGroupLabel(). All dates of a day, week or month
+ *         that share a group hence share the bucket, and the label needs to be
+ *         formatted only once per bucket.
+ */
+qint64 timeGroupBucket(const QDate &fileDate, const QDate &currentDate)
+{
+    if (!fileDate.isValid()) {
+        return -1;
+    }
 
-    QDate previousFileDate;
-    QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
-        if (isChildItem(i)) {
-            continue;
+    const qint64 daysDistance = fileDate.daysTo(currentDate);
+    if (currentDate.year() == fileDate.year() && currentDate.month() == fileDate.month()) {
+        const qint64 weeksDistance = daysDistance / 7;
+        if (weeksDistance == 0) {
+            // "Today", "Yesterday" or the name of the week day
+            return 1000 + daysDistance;
         }
+        // The fourth and the fifth week are both "Earlier this Month"
+        return 2000 + std::min<qint64>(weeksDistance, 4);
+    }
 
-        const QLocale locale;
-        const QDateTime fileTime = fileTimeCb(m_itemData.at(i));
-        const QDate fileDate = fileTime.date();
-        if (fileDate == previousFileDate) {
-            // The current item is in the same group as the previous item
-            continue;
+    const QDate lastMonthDate = currentDate.addMonths(-1);
+    if (lastMonthDate.year() == fileDate.year() && lastMonthDate.month() == fileDate.month()) {
+        if (daysDistance <= 7) {
+            // "Yesterday" or the name of the week day
+            return 3000 + daysDistance;
         }
-        previousFileDate = fileDate;
+        // "One Week Ago" to "Three Weeks Ago", or "Earlier on"
+        return 4000 + std::min<qint64>((daysDistance - 1) / 7, 4);
+    }
 
-        const int daysDistance = fileDate.daysTo(currentDate);
+    return (qint64(1) << 32) + qint64(fileDate.year()) * 12 + fileDate.month();
+}
 
-        QString newGroupValue;
-        if (currentDate.year() == fileDate.year() && currentDate.month() == fileDate.month()) {
-            switch (daysDistance / 7) {
+QString timeGroupLabel(const QDateTime &fileTime, const QDate &currentDate, const QLocale &locale)
+{
+    const QDate fileDate = fileTime.date();
+    const int daysDistance = fileDate.daysTo(currentDate);
+
+    QString groupValue;
+    if (currentDate.year() == fileDate.year() && currentDate.month() == fileDate.month()) {
+        switch (daysDistance / 7) {
+        case 0:
+            switch (daysDistance) {
             case 0:
-                switch (daysDistance) {
-                case 0:
-                    newGroupValue = i18nc("@title:group Date", "Today");
-                    break;
-                case 1:
-                    newGroupValue = i18nc("@title:group Date", "Yesterday");
-                    break;
-                default:
-                    newGroupValue = locale.toString(fileTime, i18nc("@title:group Date: The week day name: dddd", "dddd"));
-                    newGroupValue = i18nc(
-                        "Can be used to script translation of \"dddd\""
-                        "with context @title:group Date",
-                        "%1",
-                        newGroupValue);
-                }
+                groupValue = i18nc("@title:group Date", "Today");
                 break;
             case 1:
-                newGroupValue = i18nc("@title:group Date", "One Week Ago");
-                break;
-            case 2:
-                newGroupValue = i18nc("@title:group Date", "Two Weeks Ago");
-                break;
-            case 3:
-                newGroupValue = i18nc("@title:group Date", "Three Weeks Ago");
-                break;
-            case 4:
-            case 5:
-                newGroupValue = i18nc("@title:group Date", "Earlier this Month");
+                groupValue = i18nc("@title:group Date", "Yesterday");
                 break;
             default:
-                Q_ASSERT(false);
+                groupValue = locale.toString(fileTime, i18nc("@title:group Date: The week day name: dddd", "dddd"));
+                groupValue = i18nc(
+                    "Can be used to script translation of \"dddd\""
+                    "with context @title:group Date",
+                    "%1",
+                    groupValue);
             }
-        } else {
-            const QDate lastMonthDate = currentDate.addMonths(-1);
-            if (lastMonthDate.year() == fileDate.year() && lastMonthDate.month() == fileDate.month()) {
-                if (daysDistance == 1) {
-                    const KLocalizedString format = ki18nc(
-                        "@title:group Date: "
-                        "MMMM is full month name in current locale, and yyyy is "
-                        "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
-                        "part of the text that should not be formatted as a date",
-                        "'Yesterday' (MMMM, yyyy)");
-                    const QString translatedFormat = format.toString();
-                    if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
-                        newGroupValue = locale.toString(fileTime, translatedFormat);
-                        newGroupValue = i18nc(
-                            "Can be used to script translation of "
-                            "\"'Yesterday' (MMMM, yyyy)\" with context @title:group Date",
-                            "%1",
-                            newGroupValue);
-                    } else {
-                        qCWarning(DolphinDebug).nospace()
-                            << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
-                        const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
-                        newGroupValue = locale.toString(fileTime, untranslatedFormat);
-                    }
-                } else if (daysDistance <= 7) {
-                    newGroupValue = locale.toString(fileTime,
-                                                    i18nc("@title:group Date: "
-                                                          "The week day name: dddd, MMMM is full month name "
-                                                          "in current locale, and yyyy is full year number.",
-                                                          "dddd (MMMM, yyyy)"));
-                    newGroupValue = i18nc(
+            break;
+        case 1:
+            groupValue = i18nc("@title:group Date", "One Week Ago");
+            break;
+        case 2:
+            groupValue = i18nc("@title:group Date", "Two Weeks Ago");
+            break;
+        case 3:
+            groupValue = i18nc("@title:group Date", "Three Weeks Ago");
+            break;
+        case 4:
+        case 5:
+            groupValue = i18nc("@title:group Date", "Earlier this Month");
+            break;
+        default:
+            Q_ASSERT(false);
+        }
+    } else {
+        const QDate lastMonthDate = currentDate.addMonths(-1);
+        if (lastMonthDate.year() == fileDate.year() && lastMonthDate.month() == fileDate.month()) {
+            if (daysDistance == 1) {
+                const KLocalizedString format = ki18nc(
+                    "@title:group Date: "
+                    "MMMM is full month name in current locale, and yyyy is "
+                    "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
+                    "part of the text that should not be formatted as a date",
+                    "'Yesterday' (MMMM, yyyy)");
+                const QString translatedFormat = format.toString();
+                if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
+                    groupValue = locale.toString(fileTime, translatedFormat);
+                    groupValue = i18nc(
                         "Can be used to script translation of "
-                        "\"dddd (MMMM, yyyy)\" with context @title:group Date",
+                        "\"'Yesterday' (MMMM, yyyy)\" with context @title:group Date",
                         "%1",
-                        newGroupValue);
-                } else if (daysDistance <= 7 * 2) {
-                    const KLocalizedString format = ki18nc(
-                        "@title:group Date: "
-                        "MMMM is full month name in current locale, and yyyy is "
-                        "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
-                        "part of the text that should not be formatted as a date",
-                        "'One Week Ago' (MMMM, yyyy)");
-                    const QString translatedFormat = format.toString();
-                    if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
-                        newGroupValue = locale.toString(fileTime, translatedFormat);
-                        newGroupValue = i18nc(
-                            "Can be used to script translation of "
-                            "\"'One Week Ago' (MMMM, yyyy)\" with context @title:group Date",
-                            "%1",
-                            newGroupValue);
-                    } else {
-                        qCWarning(DolphinDebug).nospace()
-                            << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
-                        const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
-                        newGroupValue = locale.toString(fileTime, untranslatedFormat);
-                    }
-                } else if (daysDistance <= 7 * 3) {
-                    const KLocalizedString format = ki18nc(
-                        "@title:group Date: "
-                        "MMMM is full month name in current locale, and yyyy is "
-                        "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
-                        "part of the text that should not be formatted as a date",
-                        "'Two Weeks Ago' (MMMM, yyyy)");
-                    const QString translatedFormat = format.toString();
-                    if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
-                        newGroupValue = locale.toString(fileTime, translatedFormat);
-                        newGroupValue = i18nc(
-                            "Can be used to script translation of "
-                            "\"'Two Weeks Ago' (MMMM, yyyy)\" with context @title:group Date",
-                            "%1",
-                            newGroupValue);
-                    } else {
-                        qCWarning(DolphinDebug).nospace()
-                            << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
-                        const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
-                        newGroupValue = locale.toString(fileTime, untranslatedFormat);
-                    }
-                } else if (daysDistance <= 7 * 4) {
-                    const KLocalizedString format = ki18nc(
-                        "@title:group Date: "
-                        "MMMM is full month name in current locale, and yyyy is "
-                        "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
-                        "part of the text that should not be formatted as a date",
-                        "'Three Weeks Ago' (MMMM, yyyy)");
-                    const QString translatedFormat = format.toString();
-                    if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
-                        newGroupValue = locale.toString(fileTime, translatedFormat);
-                        newGroupValue = i18nc(
-                            "Can be used to script translation of "
-                            "\"'Three Weeks Ago' (MMMM, yyyy)\" with context @title:group Date",
-                            "%1",
-                            newGroupValue);
-                    } else {
-                        qCWarning(DolphinDebug).nospace()
-                            << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
-                        const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
-                        newGroupValue = locale.toString(fileTime, untranslatedFormat);
-                    }
+                        groupValue);
                 } else {
-                    const KLocalizedString format = ki18nc(
-                        "@title:group Date: "
-                        "MMMM is full month name in current locale, and yyyy is "
-                        "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
-                        "part of the text that should not be formatted as a date",
-                        "'Earlier on' MMMM, yyyy");
-                    const QString translatedFormat = format.toString();
-                    if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
-                        newGroupValue = locale.toString(fileTime, translatedFormat);
-                        newGroupValue = i18nc(
-                            "Can be used to script translation of "
-                            "\"'Earlier on' MMMM, yyyy\" with context @title:group Date",
-                            "%1",
-                            newGroupValue);
-                    } else {
-                        qCWarning(DolphinDebug).nospace()
-                            << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
-                        const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
-                        newGroupValue = locale.toString(fileTime, untranslatedFormat);
-                    }
+                    qCWarning(DolphinDebug).nospace()
+                        << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
+                    const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
+                    groupValue = locale.toString(fileTime, untranslatedFormat);
                 }
-            } else {
-                newGroupValue = locale.toString(fileTime,
-                                                i18nc("@title:group "
-                                                      "The month and year: MMMM is full month name in current locale, "
-                                                      "and yyyy is full year number",
-                                                      "MMMM, yyyy"));
-                newGroupValue = i18nc(
+            } else if (daysDistance <= 7) {
+                groupValue = locale.toString(fileTime,
+                                                i18nc("@title:group Date: "
+                                                      "The week day name: dddd, MMMM is full month name "
+                                                      "in current locale, and yyyy is full year number.",
+                                                      "dddd (MMMM, yyyy)"));
+                groupValue = i18nc(
                     "Can be used to script translation of "
-                    "\"MMMM, yyyy\" with context @title:group Date",
+                    "\"dddd (MMMM, yyyy)\" with context @title:group Date",
                     "%1",
-                    newGroupValue);
+                    groupValue);
+            } else if (daysDistance <= 7 * 2) {
+                const KLocalizedString format = ki18nc(
+                    "@title:group Date: "
+                    "MMMM is full month name in current locale, and yyyy is "
+                    "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
+                    "part of the text that should not be formatted as a date",
+                    "'One Week Ago' (MMMM, yyyy)");
+                const QString translatedFormat = format.toString();
+                if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
+                    groupValue = locale.toString(fileTime, translatedFormat);
+                    groupValue = i18nc(
+                        "Can be used to script translation of "
+                        "\"'One Week Ago' (MMMM, yyyy)\" with context @title:group Date",
+                        "%1",
+                        groupValue);
+                } else {
+                    qCWarning(DolphinDebug).nospace()
+                        << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
+                    const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
+                    groupValue = locale.toString(fileTime, untranslatedFormat);
+                }
+            } else if (daysDistance <= 7 * 3) {
+                const KLocalizedString format = ki18nc(
+                    "@title:group Date: "
+                    "MMMM is full month name in current locale, and yyyy is "
+                    "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
+                    "part of the text that should not be formatted as a date",
+                    "'Two Weeks Ago' (MMMM, yyyy)");
+                const QString translatedFormat = format.toString();
+                if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
+                    groupValue = locale.toString(fileTime, translatedFormat);
+                    groupValue = i18nc(
+                        "Can be used to script translation of "
+                        "\"'Two Weeks Ago' (MMMM, yyyy)\" with context @title:group Date",
+                        "%1",
+                        groupValue);
+                } else {
+                    qCWarning(DolphinDebug).nospace()
+                        << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
+                    const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
+                    groupValue = locale.toString(fileTime, untranslatedFormat);
+                }
+            } else if (daysDistance <= 7 * 4) {
+                const KLocalizedString format = ki18nc(
+                    "@title:group Date: "
+                    "MMMM is full month name in current locale, and yyyy is "
+                    "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
+                    "part of the text that should not be formatted as a date",
+                    "'Three Weeks Ago' (MMMM, yyyy)");
+                const QString translatedFormat = format.toString();
+                if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
+                    groupValue = locale.toString(fileTime, translatedFormat);
+                    groupValue = i18nc(
+                        "Can be used to script translation of "
+                        "\"'Three Weeks Ago' (MMMM, yyyy)\" with context @title:group Date",
+                        "%1",
+                        groupValue);
+                } else {
+                    qCWarning(DolphinDebug).nospace()
+                        << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
+                    const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
+                    groupValue = locale.toString(fileTime, untranslatedFormat);
+                }
+            } else {
+                const KLocalizedString format = ki18nc(
+                    "@title:group Date: "
+                    "MMMM is full month name in current locale, and yyyy is "
+                    "full year number. You must keep the ' don't use any fancy \" or « or similar. The ' is not shown to the user, it's there to mark a "
+                    "part of the text that should not be formatted as a date",
+                    "'Earlier on' MMMM, yyyy");
+                const QString translatedFormat = format.toString();
+                if (const int count = translatedFormat.count(QLatin1Char('\'')); count >= 2 && count % 2 == 0) {
+                    groupValue = locale.toString(fileTime, translatedFormat);
+                    groupValue = i18nc(
+                        "Can be used to script translation of "
+                        "\"'Earlier on' MMMM, yyyy\" with context @title:group Date",
+                        "%1",
+                        groupValue);
+                } else {
+                    qCWarning(DolphinDebug).nospace()
+                        << "A wrong translation was found: " << translatedFormat << ". Please file a bug report at bugs.kde.org";
+                    const QString untranslatedFormat = format.toString({QLatin1String("en_US")});
+                    groupValue = locale.toString(fileTime, untranslatedFormat);
+                }
             }
+        } else {
+            groupValue = locale.toString(fileTime,
+                                            i18nc("@title:group "
+                                                  "The month and year: MMMM is full month name in current locale, "
+                                                  "and yyyy is full year number",
+                                                  "MMMM, yyyy"));
+            groupValue = i18nc(
+                "Can be used to script translation of "
+                "\"MMMM, yyyy\" with context @title:group Date",
+                "%1",
+                groupValue);
         }
+    }
 
-        if (newGroupValue != groupValue) {
-            groupValue = newGroupValue;
-            groups.append(QPair<int, QVariant>(i, newGroupValue));
+    return groupValue;
+}
+}
+
+QList<QPair<int, QVariant>> KFileItemModel::timeRoleGroups(int firstIndex, int lastIndex, const std::function<QDateTime(const ItemData *)> &fileTimeCb) const
+{
+    Q_ASSERT(!m_itemData.isEmpty());
+
+    QList<QPair<int, QVariant>> groups;
+
+    const QLocale locale;
+    const QDate currentDate = QDate::currentDate();
+
+    // The items are usually sorted by time, so consecutive items mostly belong
+    // to the same day. Remembering the seconds covered by the day of the previous
+    // item allows to skip the conversion to a date for most of the items.
+    qint64 dayBegin = 0;
+    qint64 dayEnd = 0;
+
+    QHash<qint64, QString> labels;
+    qint64 previousBucket = 0;
+    bool hasPreviousBucket = false;
+
+    QString groupValue;
+    for (int i = firstIndex; i <= lastIndex; ++i) {
+        if (isChildItem(i)) {
+            continue;
+        }
+
+        const QDateTime fileTime = fileTimeCb(m_itemData.at(i));
+        if (fileTime.isValid()) {
+            const qint64 secsSinceEpoch = fileTime.toSecsSinceEpoch();
+            if (secsSinceEpoch >= dayBegin && secsSinceEpoch < dayEnd) {
+                // The current item is in the same group as the previous item
+                continue;
+            }
+            dayBegin = fileTime.date().startOfDay().toSecsSinceEpoch();
+            dayEnd = fileTime.date().addDays(1).startOfDay().toSecsSinceEpoch();
+        } else {
+            dayBegin = 0;
+            dayEnd = 0;
+        }
+
+        const qint64 bucket = timeGroupBucket(fileTime.date(), currentDate);
+        if (hasPreviousBucket && bucket == previousBucket) {
+            continue;
+        }
+        previousBucket = bucket;
+        hasPreviousBucket = true;
+
+        auto it = labels.find(bucket);
+        if (it == labels.end()) {
+            it = labels.insert(bucket, timeGroupLabel(fileTime, currentDate, locale));
+        }
+
+        if (*it != groupValue) {
+            groupValue = *it;
+            groups.append(QPair<int, QVariant>(i, groupValue));
         }
     }
 
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     QString permissionsString;
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
 
         const ItemData *itemData = m_itemData.at(i);
-        const QString newPermissionsString = itemData->values.value("permissions").toString();
+        const QString newPermissionsString = itemData->values.value(PermissionsRole).toString();
         if (newPermissionsString == permissionsString) {
             continue;
         }
@@ -3060,19 +3799,18 @@ QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     int groupValue = -1;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
-        const int newGroupValue = m_itemData.at(i)->values.value("rating", 0).toInt();
+        const int newGroupValue = m_itemData.at(i)->values.value(RatingRole, 0).toInt();
         if (newGroupValue != groupValue) {
             groupValue = newGroupValue;
             groups.append(QPair<int, QVariant>(i, newGroupValue));
@@ -3082,20 +3820,20 @@ QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::genericStringRoleGroups(const QByteArray &role) const
+QList<QPair<int, QVariant>> KFileItemModel::genericStringRoleGroups(const QByteArray &role, int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
+    const int id = roleId(role);
     bool isFirstGroupValue = true;
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
-        const QString newGroupValue = m_itemData.at(i)->values.value(role).toString();
+        const QString newGroupValue = m_itemData.at(i)->values.value(id).toString();
         if (newGroupValue != groupValue || isFirstGroupValue) {
             groupValue = newGroupValue;
             groups.append(QPair<int, QVariant>(i, newGroupValue));
@@ -3195,41 +3933,6 @@ const KFileItemModel::RoleInfoMap *KFileItemModel::rolesInfoMap(int &count)
     return rolesInfoMap;
 }
 
-void KFileItemModel::determineMimeTypes(const KFileItemList &items, int timeout)
-{
-    QElapsedTimer timer;
-    timer.start();
-    for (const KFileItem &item : items) {
-        // Only determine mime types for files here. For directories,
-        // KFileItem::determineMimeType() reads the .directory file inside to
-        // load the icon, but this is not necessary at all if we just need the
-        // type. Some special code for setting the correct mime type for
-        // directories is in retrieveData().
-        if (!item.isDir()) {
-            item.determineMimeType();
-        }
-
-        if (timer.elapsed() > timeout) {
-            // Don't block the user interface, let the remaining items
-            // be resolved asynchronously.
-            return;
-        }
-    }
-}
-
-QByteArray KFileItemModel::sharedValue(const QByteArray &value)
-{
-    static QSet<QByteArray> pool;
-    const QSet<QByteArray>::const_iterator it = pool.constFind(value);
-
-    if (it != pool.constEnd()) {
-        return *it;
-    } else {
-        pool.insert(value);
-        return value;
-    }
-}
-
 bool KFileItemModel::isConsistent() const
 {
     // m_items may contain less items than m_itemData because m_items
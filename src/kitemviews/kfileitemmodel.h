@@ -21,7 +21,9 @@
 #include <QUrl>
 #include <QVariant>
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 class KDirLister;
 
@@ -83,6 +85,14 @@ public:
     QUrl url(int index) const override;
     bool setData(int index, const SmallHash &values) override;
 
+    /**
+     * Sets the values of several items like setData(), but emits
+     * itemsChanged() only once for all changed items.
+     * @param itemsValues Values of the items by item index.
+     * @return            True if the values of any item have been changed.
+     */
+    bool setItemsData(const QHash<int, SmallHash> &itemsValues);
+
     /**
      * Sets a separate sorting with directories first (true) or a mixed
      * sorting of files and directories (false).
@@ -163,6 +173,15 @@ public:
     QSet<QByteArray> roles() const;
 
     bool setExpanded(int index, bool expanded) override;
+
+    /**
+     * Expands the directories of the subtree level by level. All directories
+     * of a level are listed concurrently, and their items are inserted into
+     * the model at once after the listing of the level has been completed.
+     * Directories that cannot be listed are skipped. The expanding is stopped
+     * by cancelDirectoryLoading(). The progress is reported by subtreeExpansionProgress().
+     */
+    bool expandSubtree(int index, int maximumDepth) override;
     bool isExpanded(int index) const override;
     bool isExpandable(int index) const override;
     int expandedParentsCount(int index) const override;
@@ -196,6 +215,39 @@ public:
     void setExcludeMimeTypeFilter(const QStringList &filters);
     QStringList excludeMimeTypeFilter() const;
 
+    /**
+     * Sets the term of the search whose results are listed by the next call
+     * of loadDirectory() or refreshDirectory(). While the search is running,
+     * the results are shown in the order in which they arrive, except for the
+     * first items, which are ordered by how well their names match the term.
+     * The items are sorted when the search has been completed or canceled, or
+     * when sortDeferredItems() is called. An empty term disables the search
+     * results mode.
+     */
+    void setSearchTerm(const QString &searchTerm);
+    QString searchTerm() const;
+
+    /**
+     * @return True if the items are shown in the order of their arrival
+     *         because the search has not been completed yet.
+     */
+    bool isSortingDeferred() const;
+
+    /**
+     * Sorts the items that have been shown in the order of their arrival.
+     */
+    void sortDeferredItems();
+
+    /**
+     * Sets the range of items that are visible in the view and the maximum
+     * number of items that fit into the view. While a large directory is being
+     * loaded, the first items are inserted as soon as they fill the view, and
+     * the items that arrive later are not inserted before the last visible item.
+     * The visible items stay in place until the loading has been completed.
+     */
+    void setVisibleIndexRange(int index, int count);
+    void setMaximumVisibleItems(int count);
+
     struct RoleInfo {
         QByteArray role;
         QString translation;
@@ -257,6 +309,12 @@ Q_SIGNALS:
      */
     void directorySortingProgress(int percent);
 
+    /**
+     * Informs about the progress in percent of expanding a subtree with
+     * expandSubtree(). It is assured that the last signal contains 100 as value.
+     */
+    void subtreeExpansionProgress(int percent);
+
     /**
      * Is emitted if an information message (e.g. "Connecting to host...")
      * should be shown.
@@ -307,6 +365,8 @@ private Q_SLOTS:
 
     void slotCompleted();
     void slotCanceled();
+    void slotListingDirCompleted(const QUrl &url);
+    void slotListingDirCanceled(const QUrl &url);
     void slotItemsAdded(const QUrl &directoryUrl, const KFileItemList &items);
     void slotItemsDeleted(const KFileItemList &items);
     void slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items);
@@ -314,9 +374,30 @@ private Q_SLOTS:
     void slotSortingChoiceChanged();
     void slotListerError(KIO::Job *job);
 
+    /**
+     * Inserts the pending items while the directory is still being loaded.
+     * If the first items of a large directory have been inserted already,
+     * the interval until the next pending items are inserted is increased.
+     */
+    void slotMaximumUpdateIntervalExceeded();
+
     void dispatchPendingItemsToInsert();
 
 private:
+    /**
+     * Expands the directories \a urls as next level of the subtree
+     * that is expanded by expandSubtree().
+     */
+    void expandSubtreeLevel(const QList<QUrl> &urls);
+
+    /**
+     * Starts expanding the next level of the subtree after the current level has
+     * been inserted, if the maximum depth has not been reached yet.
+     */
+    void finishSubtreeLevel();
+
+    void resetSubtreeExpansion();
+
     enum RoleType {
         // User visible roles:
         NoRole,
@@ -374,9 +455,81 @@ private:
         RolesCount
     };
 
+    /**
+     * Values of the roles of an item, sorted by the role ID. The ID of a role
+     * of RoleType is its enum value, other roles like "iconPixmap" that are set
+     * by KFileItemModel::setData() get an ID by KFileItemModel::roleId().
+     * The role names are only used by data() and setData().
+     */
+    class RoleValues
+    {
+    public:
+        bool isEmpty() const
+        {
+            return m_values.empty();
+        }
+        int count() const
+        {
+            return static_cast<int>(m_values.size());
+        }
+        bool contains(int role) const
+        {
+            const auto it = lowerBound(role);
+            return it != m_values.end() && it->first == role;
+        }
+        QVariant value(int role, const QVariant &defaultValue = QVariant()) const
+        {
+            const auto it = lowerBound(role);
+            return (it != m_values.end() && it->first == role) ? it->second : defaultValue;
+        }
+        void insert(int role, const QVariant &value)
+        {
+            const auto it = lowerBound(role);
+            if (it != m_values.end() && it->first == role) {
+                m_values[it - m_values.begin()].second = value;
+            } else {
+                m_values.emplace(it, role, value);
+            }
+        }
+        void remove(int role)
+        {
+            const auto it = lowerBound(role);
+            if (it != m_values.end() && it->first == role) {
+                m_values.erase(it);
+            }
+        }
+        void clear()
+        {
+            m_values.clear();
+            m_values.shrink_to_fit();
+        }
+        void reserve(int size)
+        {
+            m_values.reserve(size);
+        }
+        std::vector<std::pair<int, QVariant>>::const_iterator begin() const
+        {
+            return m_values.begin();
+        }
+        std::vector<std::pair<int, QVariant>>::const_iterator end() const
+        {
+            return m_values.end();
+        }
+
+    private:
+        std::vector<std::pair<int, QVariant>>::const_iterator lowerBound(int role) const
+        {
+            return std::lower_bound(m_values.begin(), m_values.end(), role, [](const std::pair<int, QVariant> &value, int role) {
+                return value.first < role;
+            });
+        }
+
+        std::vector<std::pair<int, QVariant>> m_values;
+    };
+
     struct ItemData {
         KFileItem item;
-        SmallHash values;
+        RoleValues values;
         ItemData *parent;
     };
 
@@ -387,6 +540,28 @@ private:
     };
 
     void insertItems(QList<ItemData *> &items);
+
+    /**
+     * Ends keeping the visible items in place after a large directory has been
+     * loaded, and sorts the items that have been inserted behind them.
+     */
+    void finishProgressiveLoading();
+
+    /**
+     * Helper method for insertItems() while the sorting is deferred: Inserts
+     * the most relevant items of \a newItems among the first items of the model
+     * and appends the other items in the order of their arrival.
+     */
+    void insertSearchResults(const QList<ItemData *> &newItems);
+
+    /**
+     * @return How well the name of \a item matches m_searchTerm. Exact matches
+     *         have the highest relevance, followed by names that start with the
+     *         term, names that contain the term at the start of a word, and
+     *         names that contain the term anywhere.
+     */
+    int searchRelevance(const ItemData *item) const;
+
     void removeItems(const KItemRangeList &itemRanges, RemoveItemsBehavior behavior);
 
     /**
@@ -404,10 +579,23 @@ private:
      */
     void prepareItemsForSorting(QList<ItemData *> &itemDataList);
 
+    /**
+     * Retrieves the values of the items in \a itemDataList that have no values yet.
+     * For large lists, the values are retrieved on several threads.
+     */
+    void retrieveMissingData(const QList<ItemData *> &itemDataList) const;
+
     static int expandedParentsCount(const ItemData *data);
 
     void removeExpandedItems();
 
+    /**
+     * Stores \a values for the item with the index \a index without
+     * emitting any signal.
+     * @return Roles whose values have been changed.
+     */
+    QSet<QByteArray> applyData(int index, const SmallHash &values);
+
     /**
      * This function is called by setData() and slotRefreshItems(). It emits
      * the itemsChanged() signal, checks if the sort order is still correct,
@@ -424,15 +612,33 @@ private:
      * @return Role-type for the given role.
      *         Runtime complexity is O(1).
      */
-    RoleType typeForRole(const QByteArray &role) const;
+    static RoleType typeForRole(const QByteArray &role);
 
     /**
      * @return Role-byte-array for the given role-type.
      *         Runtime complexity is O(1).
      */
-    QByteArray roleForType(RoleType roleType) const;
+    static QByteArray roleForType(RoleType roleType);
 
-    SmallHash retrieveData(const KFileItem &item, const ItemData *parent) const;
+    /**
+     * @return ID of \a role in RoleValues. Roles that are not part of RoleType
+     *         get an ID above RolesCount when they are used the first time.
+     *         Is thread-safe.
+     */
+    static int roleId(const QByteArray &role);
+
+    /**
+     * @return Name of the role with the ID \a id. Is thread-safe.
+     */
+    static QByteArray roleName(int id);
+
+    /**
+     * Retrieves the values of the item if they have not been retrieved yet
+     * or have been cleared by slotRefreshItems().
+     */
+    void ensureValuesRetrieved(ItemData *data) const;
+
+    RoleValues retrieveData(const KFileItem &item, const ItemData *parent) const;
 
     /**
      * @return True if role values benefit from natural or case insensitive sorting.
@@ -468,12 +674,49 @@ private:
 
     int stringCompare(const QString &a, const QString &b, const QCollator &collator) const;
 
-    QList<QPair<int, QVariant>> nameRoleGroups() const;
-    QList<QPair<int, QVariant>> sizeRoleGroups() const;
-    QList<QPair<int, QVariant>> timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb) const;
-    QList<QPair<int, QVariant>> permissionRoleGroups() const;
-    QList<QPair<int, QVariant>> ratingRoleGroups() const;
-    QList<QPair<int, QVariant>> genericStringRoleGroups(const QByteArray &typeForRole) const;
+    /**
+     * @return Groups for the items in the range [\a firstIndex, \a lastIndex]
+     *         according to the group role. The first item of the range starts
+     *         a group unless its group value is empty.
+     */
+    QList<QPair<int, QVariant>> computeGroups(int firstIndex, int lastIndex) const;
+
+    /**
+     * Updates the cached groups after items have been inserted or removed
+     * without regrouping all items: The indexes of the existing groups are
+     * shifted, and only the items in the ranges and their next neighbours are
+     * regrouped. Must be called after m_itemData has been updated.
+     *
+     * @param itemRanges Inserted or removed item ranges, with the indexes
+     *                   as used in the itemsInserted() and itemsRemoved() signals.
+     */
+    void updateGroupsForInsertedItems(const KItemRangeList &itemRanges);
+    void updateGroupsForRemovedItems(const KItemRangeList &itemRanges);
+
+    /**
+     * Helper method for updateGroupsForInsertedItems() and updateGroupsForRemovedItems():
+     * Regroups the items in the range [\a firstIndex, \a lastIndex] and the
+     * next item that is no child-item. The range may be empty
+     * (lastIndex == firstIndex - 1) if items have been removed at \a firstIndex.
+     */
+    void updateGroupsInRange(int firstIndex, int lastIndex);
+
+    QList<QPair<int, QVariant>> nameRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> sizeRoleGroups(int firstIndex, int lastIndex) const;
+
+    /**
+     * @param fileTimeCb Provides the time of an item in seconds since the epoch,
+     *                   or -1 if the time is unknown.
+     */
+    QList<QPair<int, QVariant>> timeRoleGroups(int firstIndex, int lastIndex, const std::function<QDateTime(const ItemData *)> &fileTimeCb) const;
+    QList<QPair<int, QVariant>> permissionRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> ratingRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> genericStringRoleGroups(const QByteArray &typeForRole, int firstIndex, int lastIndex) const;
+
+    /**
+     * @return Group value of nameRoleGroups() for names that start with \a firstChar.
+     */
+    QString nameRoleGroupValue(QChar firstChar) const;
 
     /**
      * Helper method for all xxxRoleGroups() methods to check whether the
@@ -528,18 +771,6 @@ private:
      */
     static const RoleInfoMap *rolesInfoMap(int &count);
 
-    /**
-     * Determines the MIME-types of all items that can be done within
-     * the given timeout.
-     */
-    static void determineMimeTypes(const KFileItemList &items, int timeout);
-
-    /**
-     * @return Returns a copy of \a value that is implicitly shared
-     * with other users to save memory.
-     */
-    static QByteArray sharedValue(const QByteArray &value);
-
     /**
      * Checks if the model's internal data structures are consistent.
      */
@@ -593,9 +824,32 @@ private:
     // and done step after step in slotCompleted().
     QSet<QUrl> m_urlsToExpand;
 
+    // State of the subtree expansion started by expandSubtree(): The directories of the
+    // current level, the directories of the level that are still being listed,
+    // the current level and the maximum depth.
+    QList<QUrl> m_subtreeLevelUrls;
+    QSet<QUrl> m_subtreeUrlsToList;
+    int m_subtreeLevel;
+    int m_subtreeMaximumDepth;
+
+    // Term of the search whose results are listed, see setSearchTerm()
+    QString m_searchTerm;
+    bool m_sortingDeferred;
+
+    // See setVisibleIndexRange() and setMaximumVisibleItems()
+    int m_lastVisibleIndex;
+    int m_maximumVisibleItems;
+
+    // True while a large directory is loaded whose first items have been inserted
+    // early. m_resortAfterLoading is set if items have been inserted behind the
+    // visible items although they belong before them.
+    bool m_loadingProgressively;
+    bool m_resortAfterLoading;
+
     friend class KFileItemModelRolesUpdater; // Accesses emitSortProgress() method
     friend class KFileItemModelTest; // For unit testing
     friend class KFileItemModelBenchmark; // For unit testing
+    friend class KItemListViewBenchmark; // For unit testing
     friend class KFileItemListViewTest; // For unit testing
     friend class DolphinPart; // Accesses m_dirLister
 };
@@ -7,8 +7,10 @@
 #include "kfileitemmodelrolesupdater.h"
 
 #include "dolphindebug.h"
+#include "dolphintrace.h"
 #include "kfileitemmodel.h"
 #include "private/kdirectorycontentscounter.h"
+#include "private/kitemlisthoversequencecache.h"
 #include "private/kpixmapmodifier.h"
 
 #include <KConfig>
@@ -26,7 +28,6 @@
 
 #if HAVE_BALOO
 #include "private/kbaloorolesprovider.h"
-#include <Baloo/File>
 #include <Baloo/FileMonitor>
 #endif
 
@@ -39,25 +40,44 @@
 #include <QPointer>
 #include <QScopedValueRollback>
 #include <QTimer>
+#include <QtConcurrentRun>
 #include <chrono>
+#include <utility>
 
 using namespace std::chrono_literals;
 
-// #define KFILEITEMMODELROLESUPDATER_DEBUG
-
 namespace
 {
 // Maximum time in ms that the KFileItemModelRolesUpdater
 // may perform a blocking operation
 const int MaxBlockTimeout = 200;
 
+// Maximum time in ms that resolveNextSortRole() and resolveNextPendingRoles()
+// spend per event loop iteration, so that the view stays responsive
+const int ResolveTimeSlice = 15;
+
 // If the number of items is smaller than ResolveAllItemsLimit,
 // the roles of all items will be resolved.
 const int ResolveAllItemsLimit = 500;
 
+#if HAVE_BALOO
+// Maximum number of files whose Baloo roles are loaded by one worker job
+const int BalooBatchSize = 200;
+#endif
+
+// Maximum number of items whose overlays are loaded by one worker job
+const int OverlayBatchSize = 200;
+
 // Not only the visible area, but up to ReadAheadPages before and after
 // this area will be resolved.
 const int ReadAheadPages = 5;
+
+// While scrolling with at least one page per second, the items that get visible
+// within the next ReadAheadTime ms in the scroll direction are resolved, and the
+// read-ahead area in the opposite direction is reduced to one page. If the visible
+// range has not been changed for ScrollIdleTimeout ms, scrolling is considered finished.
+const int ReadAheadTime = 2000;
+const int ScrollIdleTimeout = 300;
 }
 
 KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QObject *parent)
@@ -76,6 +96,8 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     , m_firstVisibleIndex(0)
     , m_lastVisibleIndex(-1)
     , m_maximumVisibleItems(50)
+    , m_visibleIndexRangeTimer()
+    , m_scrollVelocity(0)
     , m_roles()
     , m_resolvableRoles()
     , m_enabledPlugins()
@@ -91,8 +113,17 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     , m_recentlyChangedItems()
     , m_changedItems()
     , m_directoryContentsCounter(nullptr)
+    , m_overlayIconsPlugin()
+    , m_threadSafeOverlayIconPlugins()
+    , m_pendingOverlayUrls()
+    , m_loadingOverlayUrls()
+    , m_threadSafeOverlays()
+    , m_overlaysWatcher(nullptr)
 #if HAVE_BALOO
     , m_balooFileMonitor(nullptr)
+    , m_pendingBalooFiles()
+    , m_loadingBalooFiles()
+    , m_balooRolesWatcher(nullptr)
 #endif
 {
     Q_ASSERT(model);
@@ -118,6 +149,9 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     m_resolvableRoles.insert("isExpandable");
 #if HAVE_BALOO
     m_resolvableRoles += KBalooRolesProvider::instance().roles();
+
+    m_balooRolesWatcher = new QFutureWatcher<QList<SmallHash>>(this);
+    connect(m_balooRolesWatcher, &QFutureWatcher<QList<SmallHash>>::finished, this, &KFileItemModelRolesUpdater::slotBalooRolesLoaded);
 #endif
 
     m_directoryContentsCounter = new KDirectoryContentsCounter(m_model, this);
@@ -128,13 +162,20 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
         auto instance = QPluginLoader(data.fileName()).instance();
         auto plugin = qobject_cast<KOverlayIconPlugin *>(instance);
         if (plugin) {
-            m_overlayIconsPlugin.append(plugin);
+            if (data.value(QStringLiteral("X-Dolphin-ThreadSafe"), false)) {
+                m_threadSafeOverlayIconPlugins.append(plugin);
+            } else {
+                m_overlayIconsPlugin.append(plugin);
+            }
             connect(plugin, &KOverlayIconPlugin::overlaysChanged, this, &KFileItemModelRolesUpdater::slotOverlaysChanged);
         } else {
             // not our/valid plugin, so delete the created object
             delete instance;
         }
     }
+
+    m_overlaysWatcher = new QFutureWatcher<QList<QStringList>>(this);
+    connect(m_overlaysWatcher, &QFutureWatcher<QList<QStringList>>::finished, this, &KFileItemModelRolesUpdater::slotOverlaysLoaded);
 }
 
 KFileItemModelRolesUpdater::~KFileItemModelRolesUpdater()
@@ -195,6 +236,16 @@ void KFileItemModelRolesUpdater::setVisibleIndexRange(int index, int count)
         return;
     }
 
+    // Estimate the scroll velocity, which determines the read-ahead area in indexesToResolve()
+    const qint64 elapsed = m_visibleIndexRangeTimer.isValid() ? m_visibleIndexRangeTimer.restart() : -1;
+    if (elapsed < 0 || elapsed > ScrollIdleTimeout) {
+        m_visibleIndexRangeTimer.start();
+        m_scrollVelocity = 0;
+    } else {
+        const qreal velocity = 1000.0 * (index - m_firstVisibleIndex) / qMax<qint64>(elapsed, 1);
+        m_scrollVelocity = (m_scrollVelocity + velocity) / 2;
+    }
+
     m_firstVisibleIndex = index;
     m_lastVisibleIndex = qMin(index + count - 1, m_model->count() - 1);
 
@@ -368,7 +419,7 @@ void KFileItemModelRolesUpdater::slotItemsInserted(const KItemRangeList &itemRan
     timer.start();
 
     // Determine the sort role synchronously for as many items as possible.
-    if (m_resolvableRoles.contains(m_model->sortRole())) {
+    if (sortRoleNeedsResolving()) {
         QList<QUrl> dirsWithAddedItems;
 
         int insertedCount = 0;
@@ -417,6 +468,7 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
         // Don't let the FileWatcher watch for removed items
         if (allItemsRemoved) {
             m_balooFileMonitor->clear();
+            m_pendingBalooFiles.clear();
         } else {
             QStringList newFileList;
             const QStringList oldFileList = m_balooFileMonitor->files();
@@ -433,6 +485,9 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
     if (allItemsRemoved) {
         m_state = Idle;
 
+        m_pendingOverlayUrls.clear();
+        m_threadSafeOverlays.clear();
+
         m_finishedItems.clear();
         m_pendingSortRoleItems.clear();
         m_pendingIndexes.clear();
@@ -440,7 +495,6 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
         m_recentlyChangedItems.clear();
         m_recentlyChangedItemsTimer->stop();
         m_changedItems.clear();
-        m_hoverSequenceLoadedItems.clear();
 
         killPreviewJob();
         if (!m_model->showDirectoriesOnly()) {
@@ -466,16 +520,6 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
 
         recountDirectoryItems(dirsWithDeletedItems);
 
-        // Removed items won't have hover previews loaded anymore.
-        for (const KItemRange &itemRange : itemRanges) {
-            int index = itemRange.index;
-            for (int count = itemRange.count; count > 0; --count) {
-                const KFileItem item = m_model->fileItem(index);
-                m_hoverSequenceLoadedItems.remove(item);
-                ++index;
-            }
-        }
-
         // The visible items might have changed.
         startUpdating();
     }
@@ -528,7 +572,7 @@ void KFileItemModelRolesUpdater::slotSortRoleChanged(const QByteArray &current,
     Q_UNUSED(current)
     Q_UNUSED(previous)
 
-    if (m_resolvableRoles.contains(current)) {
+    if (sortRoleNeedsResolving()) {
         m_pendingSortRoleItems.clear();
         m_finishedItems.clear();
 
@@ -573,6 +617,8 @@ void KFileItemModelRolesUpdater::slotGotPreview(const KFileItem &item, const QIm
         return;
     }
 
+    const DolphinTraceSpan span("KFileItemModelRolesUpdater::slotGotPreview");
+
     SmallHash data = rolesData(item, index);
     data.insert("iconPixmap", transformPreviewImage(image));
     data.insert("supportsSequencing", m_previewJob->handlesSequences());
@@ -630,17 +676,19 @@ void KFileItemModelRolesUpdater::slotHoverSequenceGotPreview(const KFileItem &it
         return;
     }
 
-    SmallHash data = m_model->data(index);
-    QVector<QPixmap> pixmaps = data["hoverSequencePixmaps"].value<QVector<QPixmap>>();
-    const int loadedIndex = pixmaps.size();
+    // The sequence index 0 is not stored in the cache ("iconPixmap" is used instead)
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QSize frameSize = hoverSequenceFrameSize();
+    const QDateTime modificationTime = item.time(KFileItem::ModificationTime);
+    const int loadedIndex = cache->frameCount(item.url(), frameSize, modificationTime) + 1;
 
+    SmallHash data;
     float wap = m_hoverSequencePreviewJob->sequenceIndexWraparoundPoint();
     if (!m_hoverSequencePreviewJob->handlesSequences()) {
         wap = 1.0f;
     }
     if (wap >= 0.0f) {
-        data["hoverSequenceWraparoundPoint"] = wap;
-        setModelData(index, data);
+        data.insert("hoverSequenceWraparoundPoint", wap);
     }
 
     // For hover sequence previews we never load index 0, because that's just the regular preview
@@ -648,20 +696,15 @@ void KFileItemModelRolesUpdater::slotHoverSequenceGotPreview(const KFileItem &it
     // sequences, in which case we can just throw away the preview because it's the same as for
     // index 0. Unfortunately we can't find it out earlier :(
     if (wap < 0.0f || loadedIndex < static_cast<int>(wap)) {
-        // Add the preview to the model data
-
-        const QPixmap scaledPixmap = transformPreviewImage(image);
-
-        pixmaps.append(scaledPixmap);
-        data["hoverSequencePixmaps"] = QVariant::fromValue(pixmaps);
+        // Add the preview to the frames in the cache. The frames are not part of the
+        // model data, so the number of loaded frames is stored to let the hovered
+        // widget show the new frame immediately instead of at its next hover tick.
+        cache->appendFrame(item.url(), frameSize, modificationTime, transformPreviewImage(image));
+        data.insert("hoverSequenceFrameCount", loadedIndex);
+    }
 
+    if (!data.isEmpty()) {
         setModelData(index, data);
-
-        const auto loadedIt = std::find(m_hoverSequenceLoadedItems.begin(), m_hoverSequenceLoadedItems.end(), item);
-        if (loadedIt == m_hoverSequenceLoadedItems.end()) {
-            m_hoverSequenceLoadedItems.push_back(item);
-            trimHoverSequenceLoadedItems();
-        }
     }
 
     m_hoverSequenceNumSuccessiveFailures = 0;
@@ -676,27 +719,28 @@ void KFileItemModelRolesUpdater::slotHoverSequencePreviewFailed(const KFileItem
 
     static const int numRetries = 2;
 
-    SmallHash data = m_model->data(index);
-    QVector<QPixmap> pixmaps = data["hoverSequencePixmaps"].value<QVector<QPixmap>>();
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QSize frameSize = hoverSequenceFrameSize();
+    const QDateTime modificationTime = item.time(KFileItem::ModificationTime);
+    const int frameCount = cache->frameCount(item.url(), frameSize, modificationTime);
 
-    qCDebug(DolphinDebug).nospace() << "Failed to generate hover sequence preview #" << pixmaps.size() << " for file " << item.url().toString() << " (attempt "
+    qCDebug(DolphinDebug).nospace() << "Failed to generate hover sequence preview #" << frameCount + 1 << " for file " << item.url().toString() << " (attempt "
                                     << (m_hoverSequenceNumSuccessiveFailures + 1) << "/" << (numRetries + 1) << ")";
 
     if (m_hoverSequenceNumSuccessiveFailures >= numRetries) {
         // Give up and simply duplicate the previous sequence image (if any)
 
-        pixmaps.append(pixmaps.empty() ? QPixmap() : pixmaps.last());
-        data["hoverSequencePixmaps"] = QVariant::fromValue(pixmaps);
+        cache->appendFrame(item.url(), frameSize, modificationTime, cache->frame(item.url(), frameSize, frameCount));
 
+        SmallHash data = m_model->data(index);
         if (!data.contains("hoverSequenceWraparoundPoint")) {
             // hoverSequenceWraparoundPoint is only available when PreviewJob succeeds, so unless
             // it has previously succeeded, it's best to assume that it just doesn't handle
             // sequences instead of trying to load the next image indefinitely.
             data["hoverSequenceWraparoundPoint"] = 1.0f;
+            m_model->setData(index, data);
         }
 
-        m_model->setData(index, data);
-
         m_hoverSequenceNumSuccessiveFailures = 0;
     } else {
         // Retry
@@ -731,8 +775,12 @@ void KFileItemModelRolesUpdater::resolveNextSortRole()
         return;
     }
 
+    QElapsedTimer timer;
+    timer.start();
+    m_batchModelData = true;
+
     QSet<KFileItem>::iterator it = m_pendingSortRoleItems.begin();
-    while (it != m_pendingSortRoleItems.end()) {
+    while (it != m_pendingSortRoleItems.end() && timer.elapsed() < ResolveTimeSlice) {
         const KFileItem item = *it;
         const int index = m_model->index(item);
 
@@ -744,10 +792,11 @@ void KFileItemModelRolesUpdater::resolveNextSortRole()
         }
 
         applySortRole(index);
-        m_pendingSortRoleItems.erase(it);
-        break;
+        it = m_pendingSortRoleItems.erase(it);
     }
 
+    applyBatchedModelData();
+
     if (!m_pendingSortRoleItems.isEmpty()) {
         applySortProgressToModel();
         QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::resolveNextSortRole);
@@ -768,7 +817,11 @@ void KFileItemModelRolesUpdater::resolveNextPendingRoles()
         return;
     }
 
-    while (!m_pendingIndexes.isEmpty()) {
+    QElapsedTimer timer;
+    timer.start();
+    m_batchModelData = true;
+
+    while (!m_pendingIndexes.isEmpty() && timer.elapsed() < ResolveTimeSlice) {
         const int index = m_pendingIndexes.takeFirst();
         const KFileItem item = m_model->fileItem(index);
 
@@ -779,9 +832,10 @@ void KFileItemModelRolesUpdater::resolveNextPendingRoles()
         applyResolvedRoles(index, ResolveAll);
         m_finishedItems.insert(item);
         m_changedItems.remove(item);
-        break;
     }
 
+    applyBatchedModelData();
+
     if (!m_pendingIndexes.isEmpty()) {
         QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::resolveNextPendingRoles);
     } else {
@@ -792,12 +846,13 @@ void KFileItemModelRolesUpdater::resolveNextPendingRoles()
             if (m_finishedItems.count() != m_model->count()) {
                 SmallHash data;
                 data.insert("iconPixmap", QPixmap());
-                data.insert("hoverSequencePixmaps", QVariant::fromValue(QVector<QPixmap>()));
 
+                KItemListHoverSequenceCache *hoverSequenceCache = KItemListHoverSequenceCache::instance();
                 for (int index = 0; index <= m_model->count(); ++index) {
-                    if (m_model->data(index).contains("iconPixmap") || m_model->data(index).contains("hoverSequencePixmaps")) {
+                    if (m_model->data(index).contains("iconPixmap")) {
                         setModelData(index, data);
                     }
+                    hoverSequenceCache->remove(m_model->fileItem(index).url());
                 }
             }
             m_clearPreviews = false;
@@ -826,43 +881,185 @@ void KFileItemModelRolesUpdater::applyChangedBalooRoles(const QString &file)
         // the corresponding file has been deleted in the meantime.
         return;
     }
-    applyChangedBalooRolesForItem(item);
+    queueBalooRoles(item);
 #else
     Q_UNUSED(file)
 #endif
 }
 
-void KFileItemModelRolesUpdater::applyChangedBalooRolesForItem(const KFileItem &item)
+void KFileItemModelRolesUpdater::queueBalooRoles(const KFileItem &item)
 {
 #if HAVE_BALOO
-    Baloo::File file(item.localPath());
-    file.load();
+    m_pendingBalooFiles.append(qMakePair(item.url(), item.localPath()));
+    if (m_pendingBalooFiles.count() == 1 && !m_balooRolesWatcher->isRunning()) {
+        // Postpone the loading, so that all items resolved in this
+        // event loop iteration are loaded by one batch.
+        QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::loadPendingBalooRoles);
+    }
+#else
+    Q_UNUSED(item)
+#endif
+}
 
-    const KBalooRolesProvider &rolesProvider = KBalooRolesProvider::instance();
-    SmallHash data;
+void KFileItemModelRolesUpdater::loadPendingBalooRoles()
+{
+#if HAVE_BALOO
+    if (m_pendingBalooFiles.isEmpty() || m_balooRolesWatcher->isRunning()) {
+        return;
+    }
 
-    const auto roles = rolesProvider.roles();
-    for (const QByteArray &role : roles) {
-        // Overwrite all the role values with an empty QVariant, because the roles
-        // provider doesn't overwrite it when the property value list is empty.
-        // See bug 322348
-        data.insert(role, QVariant());
+    if (!m_balooFileMonitor) {
+        // No Baloo roles are shown anymore.
+        m_pendingBalooFiles.clear();
+        return;
     }
 
-    const SmallHash roleValues = rolesProvider.roleValues(file, m_roles);
-    for (const auto &[key, value] : roleValues) {
-        data.insert(key, value);
+    m_loadingBalooFiles = m_pendingBalooFiles.mid(0, BalooBatchSize);
+    m_pendingBalooFiles.remove(0, m_loadingBalooFiles.count());
+
+    QStringList files;
+    files.reserve(m_loadingBalooFiles.count());
+    for (const QPair<QUrl, QString> &file : std::as_const(m_loadingBalooFiles)) {
+        m_balooFileMonitor->addFile(file.second);
+        files.append(file.second);
     }
 
-    const int index = m_model->index(item);
-    setModelData(index, data);
-#else
-#ifndef Q_CC_MSVC
-    Q_UNUSED(item)
+    const QSet<QByteArray> roles = m_roles;
+    m_balooRolesWatcher->setFuture(QtConcurrent::run([files, roles]() {
+        return KBalooRolesProvider::instance().roleValues(files, roles);
+    }));
 #endif
+}
+
+void KFileItemModelRolesUpdater::slotBalooRolesLoaded()
+{
+#if HAVE_BALOO
+    const QList<QPair<QUrl, QString>> files = std::exchange(m_loadingBalooFiles, {});
+    const QList<SmallHash> values = m_balooRolesWatcher->result();
+    Q_ASSERT(files.count() == values.count());
+
+    const auto balooRoles = KBalooRolesProvider::instance().roles();
+    QHash<int, SmallHash> itemsData;
+    for (int i = 0; i < files.count(); ++i) {
+        const int index = m_model->index(files.at(i).first);
+        if (index < 0) {
+            // The item has been removed in the meantime.
+            continue;
+        }
+
+        SmallHash &data = itemsData[index];
+        for (const QByteArray &role : balooRoles) {
+            // Overwrite all the role values with an empty QVariant, because the roles
+            // provider doesn't overwrite it when the property value list is empty.
+            // See bug 322348
+            data.insert(role, QVariant());
+        }
+        for (const auto &[key, value] : values.at(i)) {
+            data.insert(key, value);
+        }
+    }
+
+    if (!itemsData.isEmpty()) {
+        const QScopedValueRollback<bool> guard(m_applyingChangesToModel, true);
+        m_model->setItemsData(itemsData);
+    }
+
+    loadPendingBalooRoles();
 #endif
 }
 
+void KFileItemModelRolesUpdater::queueOverlays(const QUrl &url)
+{
+    m_pendingOverlayUrls.append(url);
+    if (m_pendingOverlayUrls.count() == 1 && !m_overlaysWatcher->isRunning()) {
+        // Postpone the loading, so that all items resolved in this
+        // event loop iteration are loaded by one batch.
+        QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::loadPendingOverlays);
+    }
+}
+
+void KFileItemModelRolesUpdater::loadPendingOverlays()
+{
+    if (m_pendingOverlayUrls.isEmpty() || m_overlaysWatcher->isRunning()) {
+        return;
+    }
+
+    m_loadingOverlayUrls = m_pendingOverlayUrls.mid(0, OverlayBatchSize);
+    m_pendingOverlayUrls.remove(0, m_loadingOverlayUrls.count());
+
+    const QList<QUrl> urls = m_loadingOverlayUrls;
+    const QList<KOverlayIconPlugin *> plugins = m_threadSafeOverlayIconPlugins;
+    m_overlaysWatcher->setFuture(QtConcurrent::run([urls, plugins]() {
+        QList<QStringList> overlays;
+        overlays.reserve(urls.count());
+        for (const QUrl &url : urls) {
+            QStringList itemOverlays;
+            for (KOverlayIconPlugin *plugin : plugins) {
+                itemOverlays.append(plugin->getOverlays(url));
+            }
+            overlays.append(itemOverlays);
+        }
+        return overlays;
+    }));
+}
+
+void KFileItemModelRolesUpdater::appendThreadSafeOverlays(const QUrl &url, QStringList &overlays) const
+{
+    const QStringList threadSafeOverlays = m_threadSafeOverlays.value(url);
+    for (const QString &overlay : threadSafeOverlays) {
+        if (!overlays.contains(overlay)) {
+            overlays.append(overlay);
+        }
+    }
+}
+
+void KFileItemModelRolesUpdater::slotOverlaysLoaded()
+{
+    const QList<QUrl> urls = std::exchange(m_loadingOverlayUrls, {});
+    const QList<QStringList> overlays = m_overlaysWatcher->result();
+    Q_ASSERT(urls.count() == overlays.count());
+
+    QHash<int, SmallHash> itemsData;
+    for (int i = 0; i < urls.count(); ++i) {
+        const QUrl &url = urls.at(i);
+        const int index = m_model->index(url);
+        if (index < 0) {
+            // The item has been removed in the meantime.
+            m_threadSafeOverlays.remove(url);
+            continue;
+        }
+
+        const QStringList previousOverlays = m_threadSafeOverlays.value(url);
+        if (overlays.at(i) == previousOverlays) {
+            continue;
+        }
+        if (overlays.at(i).isEmpty()) {
+            m_threadSafeOverlays.remove(url);
+        } else {
+            m_threadSafeOverlays.insert(url, overlays.at(i));
+        }
+
+        // The overlays of the other plugins have been applied by rolesData() already
+        QStringList itemOverlays = m_model->data(index).value("iconOverlays").toStringList();
+        for (const QString &overlay : previousOverlays) {
+            itemOverlays.removeOne(overlay);
+        }
+        for (const QString &overlay : overlays.at(i)) {
+            if (!itemOverlays.contains(overlay)) {
+                itemOverlays.append(overlay);
+            }
+        }
+        itemsData[index].insert("iconOverlays", itemOverlays);
+    }
+
+    if (!itemsData.isEmpty()) {
+        const QScopedValueRollback<bool> guard(m_applyingChangesToModel, true);
+        m_model->setItemsData(itemsData);
+    }
+
+    loadPendingOverlays();
+}
+
 void KFileItemModelRolesUpdater::slotDirectoryContentsCountReceived(const QString &path, int count, long long size)
 {
     const bool getIsExpandableRole = m_roles.contains("isExpandable");
@@ -1045,6 +1242,11 @@ QSize KFileItemModelRolesUpdater::cacheSize()
     return (m_iconSize.width() > 128) || (m_iconSize.height() > 128) ? QSize(256, 256) : QSize(128, 128);
 }
 
+QSize KFileItemModelRolesUpdater::hoverSequenceFrameSize() const
+{
+    return m_iconSize * m_devicePixelRatio;
+}
+
 void KFileItemModelRolesUpdater::loadNextHoverSequencePreview()
 {
     if (m_hoverSequenceItem.isNull() || m_hoverSequencePreviewJob) {
@@ -1059,17 +1261,12 @@ void KFileItemModelRolesUpdater::loadNextHoverSequencePreview()
     // We generate the next few sequence indices in advance (buffering)
     const int maxSeqIdx = m_hoverSequenceIndex + 5;
 
-    SmallHash data = m_model->data(index);
+    const SmallHash data = m_model->data(index);
 
-    if (!data.contains("hoverSequencePixmaps")) {
-        // The pixmap at index 0 isn't used ("iconPixmap" will be used instead)
-        data.insert("hoverSequencePixmaps", QVariant::fromValue(QVector<QPixmap>() << QPixmap()));
-        setModelData(index, data);
-    }
-
-    const QVector<QPixmap> pixmaps = data["hoverSequencePixmaps"].value<QVector<QPixmap>>();
-
-    const int loadSeqIdx = pixmaps.size();
+    // The pixmap at index 0 isn't stored in the cache ("iconPixmap" will be used instead)
+    const int loadSeqIdx =
+        KItemListHoverSequenceCache::instance()->frameCount(m_hoverSequenceItem.url(), hoverSequenceFrameSize(), m_hoverSequenceItem.time(KFileItem::ModificationTime))
+        + 1;
 
     float wap = -1.0f;
     if (data.contains("hoverSequenceWraparoundPoint")) {
@@ -1123,7 +1320,7 @@ void KFileItemModelRolesUpdater::updateChangedItems()
 
     m_finishedItems -= m_changedItems;
 
-    if (m_resolvableRoles.contains(m_model->sortRole())) {
+    if (sortRoleNeedsResolving()) {
         m_pendingSortRoleItems += m_changedItems;
 
         if (m_state != ResolvingSortRole) {
@@ -1187,22 +1384,36 @@ void KFileItemModelRolesUpdater::updateChangedItems()
 
 void KFileItemModelRolesUpdater::setModelData(int index, const SmallHash &data)
 {
+    if (m_batchModelData) {
+        SmallHash &values = m_batchedModelData[index];
+        for (const auto &[role, value] : data) {
+            values.insert(role, value);
+        }
+        return;
+    }
+
     const QScopedValueRollback<bool> guard(m_applyingChangesToModel, true);
     m_model->setData(index, data);
 }
 
+void KFileItemModelRolesUpdater::applyBatchedModelData()
+{
+    m_batchModelData = false;
+    if (m_batchedModelData.isEmpty()) {
+        return;
+    }
+
+    const QHash<int, SmallHash> data = std::exchange(m_batchedModelData, {});
+    const QScopedValueRollback<bool> guard(m_applyingChangesToModel, true);
+    m_model->setItemsData(data);
+}
+
 void KFileItemModelRolesUpdater::applySortRole(int index)
 {
     SmallHash data;
     const KFileItem item = m_model->fileItem(index);
 
-    if (m_model->sortRole() == "type") {
-        if (!item.isMimeTypeKnown()) {
-            item.determineMimeType();
-        }
-
-        data.insert("type", item.mimeComment());
-    } else if (m_model->sortRole() == "size" && item.isLocalFile() && item.isDir()) {
+    if (m_model->sortRole() == "size" && item.isLocalFile() && item.isDir()) {
         startDirectorySizeCounting(item, index);
         return;
     } else {
@@ -1213,6 +1424,19 @@ void KFileItemModelRolesUpdater::applySortRole(int index)
     setModelData(index, data);
 }
 
+bool KFileItemModelRolesUpdater::sortRoleNeedsResolving() const
+{
+    const QByteArray sortRole = m_model->sortRole();
+    if (sortRole == "type") {
+        // KFileItemModel already sorts by the type that is guessed from the file
+        // name. The final MIME-types are determined like all other expensive roles
+        // for the interesting items only, which triggers a resorting if needed.
+        return false;
+    }
+
+    return m_resolvableRoles.contains(sortRole);
+}
+
 void KFileItemModelRolesUpdater::applySortProgressToModel()
 {
     // Inform the model about the progress of the resolved items,
@@ -1250,7 +1474,7 @@ bool KFileItemModelRolesUpdater::applyResolvedRoles(int index, ResolveHint hint,
 
         if (m_clearPreviews) {
             data.insert("iconPixmap", QPixmap());
-            data.insert("hoverSequencePixmaps", QVariant::fromValue(QVector<QPixmap>()));
+            KItemListHoverSequenceCache::instance()->remove(item.url());
         }
 
         setModelData(index, data);
@@ -1387,14 +1611,18 @@ SmallHash KFileItemModelRolesUpdater::rolesData(const KFileItem &item, int index
     for (KOverlayIconPlugin *it : std::as_const(m_overlayIconsPlugin)) {
         overlays.append(it->getOverlays(item.url()));
     }
+    // Keep the last known overlays of the thread-safe plugins until they have been reloaded
+    appendThreadSafeOverlays(item.url(), overlays);
     if (!overlays.isEmpty()) {
         data.insert("iconOverlays", overlays);
     }
+    if (!m_threadSafeOverlayIconPlugins.isEmpty()) {
+        queueOverlays(item.url());
+    }
 
 #if HAVE_BALOO
     if (m_balooFileMonitor) {
-        m_balooFileMonitor->addFile(item.localPath());
-        applyChangedBalooRolesForItem(item);
+        queueBalooRoles(item);
     }
 #endif
     return data;
@@ -1412,8 +1640,13 @@ void KFileItemModelRolesUpdater::slotOverlaysChanged(const QUrl &url, const QStr
     for (KOverlayIconPlugin *it : std::as_const(m_overlayIconsPlugin)) {
         overlays.append(it->getOverlays(url));
     }
+    appendThreadSafeOverlays(url, overlays);
     data.insert("iconOverlays", overlays);
     m_model->setData(index, data);
+
+    if (!m_threadSafeOverlayIconPlugins.isEmpty()) {
+        queueOverlays(url);
+    }
 }
 
 void KFileItemModelRolesUpdater::updateAllPreviews()
@@ -1463,17 +1696,41 @@ QList<int> KFileItemModelRolesUpdater::indexesToResolve() const
     // and before the visible range. m_maximumVisibleItems can be quite large
     // when using Compact View.
     const int readAheadItems = qMin(ReadAheadPages * m_maximumVisibleItems, ResolveAllItemsLimit / 2);
+    int itemsAfterVisibleRange = readAheadItems;
+    int itemsBeforeVisibleRange = readAheadItems;
+
+    // Extend the read-ahead area in the scroll direction while scrolling fast.
+    const bool isScrolling = m_visibleIndexRangeTimer.isValid() && m_visibleIndexRangeTimer.elapsed() <= ScrollIdleTimeout;
+    const qreal scrollVelocity = isScrolling ? m_scrollVelocity : 0;
+    const bool isScrollingFast = qAbs(scrollVelocity) >= qMax(m_maximumVisibleItems, 1);
+    const bool isScrollingBackward = isScrollingFast && scrollVelocity < 0;
+    if (isScrollingFast) {
+        const int scrollAheadItems = qBound(readAheadItems, qRound(qAbs(scrollVelocity) * ReadAheadTime / 1000), ResolveAllItemsLimit);
+        const int scrollBehindItems = qMin(m_maximumVisibleItems, readAheadItems);
+        itemsAfterVisibleRange = isScrollingBackward ? scrollBehindItems : scrollAheadItems;
+        itemsBeforeVisibleRange = isScrollingBackward ? scrollAheadItems : scrollBehindItems;
+    }
+
+    const int endExtendedVisibleRange = qMin(m_lastVisibleIndex + itemsAfterVisibleRange, count - 1);
+    const int beginExtendedVisibleRange = qMax(0, m_firstVisibleIndex - itemsBeforeVisibleRange);
+
+    // Add items before the visible range in reverse order first if scrolling backward.
+    if (isScrollingBackward) {
+        for (int i = m_firstVisibleIndex - 1; i >= beginExtendedVisibleRange; --i) {
+            result.append(i);
+        }
+    }
 
     // Add items after the visible range.
-    const int endExtendedVisibleRange = qMin(m_lastVisibleIndex + readAheadItems, count - 1);
     for (int i = m_lastVisibleIndex + 1; i <= endExtendedVisibleRange; ++i) {
         result.append(i);
     }
 
     // Add items before the visible range in reverse order.
-    const int beginExtendedVisibleRange = qMax(0, m_firstVisibleIndex - readAheadItems);
-    for (int i = m_firstVisibleIndex - 1; i >= beginExtendedVisibleRange; --i) {
-        result.append(i);
+    if (!isScrollingBackward) {
+        for (int i = m_firstVisibleIndex - 1; i >= beginExtendedVisibleRange; --i) {
+            result.append(i);
+        }
     }
 
     // Add items on the last page.
@@ -1504,26 +1761,6 @@ QList<int> KFileItemModelRolesUpdater::indexesToResolve() const
     return result;
 }
 
-void KFileItemModelRolesUpdater::trimHoverSequenceLoadedItems()
-{
-    static const size_t maxLoadedItems = 20;
-
-    size_t loadedItems = m_hoverSequenceLoadedItems.size();
-    while (loadedItems > maxLoadedItems) {
-        const KFileItem item = m_hoverSequenceLoadedItems.front();
-
-        m_hoverSequenceLoadedItems.pop_front();
-        loadedItems--;
-
-        const int index = m_model->index(item);
-        if (index >= 0) {
-            SmallHash data = m_model->data(index);
-            data["hoverSequencePixmaps"] = QVariant::fromValue(QVector<QPixmap>() << QPixmap());
-            m_model->setData(index, data);
-        }
-    }
-}
-
 void KFileItemModelRolesUpdater::resetSizeData(const int index, const int size)
 {
     auto data = m_model->data(index);
@@ -10,11 +10,11 @@
 #include "dolphin_export.h"
 #include "kitemviews/kitemmodelbase.h"
 
-#include <list>
-
 #include "config-dolphin.h"
 #include <KFileItem>
 
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QSet>
 #include <QSize>
@@ -57,7 +57,9 @@ class FileMonitor;
  *
  * 1.   If the sort role is "slow", it is determined for all items. If this
  *      cannot be finished synchronously in 200 ms, the remaining items are
- *      handled asynchronously by \a resolveNextSortRole().
+ *      handled asynchronously by \a resolveNextSortRole(). The "type" role is
+ *      an exception: KFileItemModel sorts by the type guessed from the file
+ *      name, and the final MIME-type is determined in the later phases.
  *
  * 2.   The function startUpdating(), which is called if either the sort role
  *      has been successfully determined for all items, or items are inserted
@@ -234,16 +236,23 @@ private Q_SLOTS:
     void slotOverlaysChanged(const QUrl &url, const QStringList &);
 
     /**
-     * Resolves the sort role of the next item in m_pendingSortRole, applies it
-     * to the model, and invokes itself if there are any pending items left. If
-     * that is not the case, \a startUpdating() is called.
+     * Applies the overlays of the last loaded batch to the model at once
+     * and starts loading the next batch.
+     */
+    void slotOverlaysLoaded();
+
+    /**
+     * Resolves the sort role of the next items in m_pendingSortRole for up to
+     * one time slice, applies them to the model at once, and invokes itself if
+     * there are any pending items left. If that is not the case,
+     * \a startUpdating() is called.
      */
     void resolveNextSortRole();
 
     /**
      * Resolves the icon name and (if previews are disabled) all other roles
-     * for the next interesting item. If there are no pending items left, any
-     * changed items are updated.
+     * for the next interesting items for up to one time slice. If there are
+     * no pending items left, any changed items are updated.
      */
     void resolveNextPendingRoles();
 
@@ -255,7 +264,37 @@ private Q_SLOTS:
     void resolveRecentlyChangedItems();
 
     void applyChangedBalooRoles(const QString &file);
-    void applyChangedBalooRolesForItem(const KFileItem &file);
+
+    /**
+     * Queues the item \a item, so that its Baloo roles get loaded by the
+     * next batch of loadPendingBalooRoles().
+     */
+    void queueBalooRoles(const KFileItem &item);
+
+    /**
+     * Loads the Baloo roles of up to BalooBatchSize queued files on a
+     * worker thread. The result is applied by slotBalooRolesLoaded().
+     */
+    void loadPendingBalooRoles();
+
+    /**
+     * Applies the Baloo roles of the last loaded batch to the model at once
+     * and starts loading the next batch.
+     */
+    void slotBalooRolesLoaded();
+
+    /**
+     * Queues the item with the URL \a url, so that the overlays of the
+     * thread-safe overlay icon plugins get loaded by the next batch of
+     * loadPendingOverlays().
+     */
+    void queueOverlays(const QUrl &url);
+
+    /**
+     * Loads the overlays of up to OverlayBatchSize queued items from the thread-safe
+     * overlay icon plugins on a worker thread. The result is applied by slotOverlaysLoaded().
+     */
+    void loadPendingOverlays();
 
     void slotDirectoryContentsCountReceived(const QString &path, int count, long long size);
 
@@ -313,6 +352,12 @@ private:
      */
     void applySortRole(int index);
 
+    /**
+     * @return True if the sort role of the model must be resolved for all
+     *         items before the items can be sorted correctly.
+     */
+    bool sortRoleNeedsResolving() const;
+
     void applySortProgressToModel();
 
     enum ResolveHint {
@@ -322,13 +367,28 @@ private:
     bool applyResolvedRoles(int index, ResolveHint hint, const KFileItem &referenceItem = KFileItem());
     SmallHash rolesData(const KFileItem &item, int index);
 
+    /**
+     * Appends the last loaded overlays of the thread-safe overlay icon plugins
+     * for the URL \a url to \a overlays, so that they don't disappear until
+     * the next batch has been loaded.
+     */
+    void appendThreadSafeOverlays(const QUrl &url, QStringList &overlays) const;
+
     /**
      * Sets \a data on the model item at \a index without re-entering
      * slotItemsChanged() for this self-induced change (other listeners, e.g. the
      * view, still get the change). Replaces a manual disconnect/setData/connect.
+     * While m_batchModelData is true, the data is only collected and gets
+     * applied by applyBatchedModelData().
      */
     void setModelData(int index, const SmallHash &data);
 
+    /**
+     * Applies the data collected by setModelData() to the model at once
+     * and stops collecting it.
+     */
+    void applyBatchedModelData();
+
     /**
      * Must be invoked if a property has been changed that affects
      * the look of the preview. Takes care to update all previews.
@@ -339,14 +399,19 @@ private:
 
     QList<int> indexesToResolve() const;
 
-    void trimHoverSequenceLoadedItems();
-
     void resetSizeData(const int index, const int size = 0);
 
     void recountDirectoryItems(const QList<QUrl> &directories);
 
 private:
     QSize cacheSize();
+
+    /**
+     * @return Size in device pixels of the hover sequence frames, which
+     *         is used to look them up in KItemListHoverSequenceCache.
+     */
+    QSize hoverSequenceFrameSize() const;
+
     /**
      * enqueue directory size counting for KFileItem item at index
      */
@@ -383,6 +448,11 @@ private:
     // slotItemsChanged() ignores it instead of resolving roles again.
     bool m_applyingChangesToModel = false;
 
+    // True while setModelData() collects the data in m_batchedModelData
+    // instead of applying it to the model.
+    bool m_batchModelData = false;
+    QHash<int, SmallHash> m_batchedModelData;
+
     // Remembers which items have been handled already, to prevent that
     // previews and other expensive roles are determined again.
     QSet<KFileItem> m_finishedItems;
@@ -393,6 +463,11 @@ private:
     int m_firstVisibleIndex;
     int m_lastVisibleIndex;
     int m_maximumVisibleItems;
+
+    // Time since the last change of the visible range and the estimated scroll
+    // velocity in items per second, which is negative when scrolling backward.
+    QElapsedTimer m_visibleIndexRangeTimer;
+    qreal m_scrollVelocity;
     QSet<QByteArray> m_roles;
     QSet<QByteArray> m_resolvableRoles;
     QStringList m_enabledPlugins;
@@ -416,7 +491,6 @@ private:
     int m_hoverSequenceIndex;
     KIO::PreviewJob *m_hoverSequencePreviewJob;
     int m_hoverSequenceNumSuccessiveFailures;
-    std::list<KFileItem> m_hoverSequenceLoadedItems;
 
     // When downloading or copying large files, the slot slotItemsChanged()
     // will be called periodically within a quite short delay. To prevent
@@ -433,9 +507,29 @@ private:
 
     QList<KOverlayIconPlugin *> m_overlayIconsPlugin;
 
+    // Overlay icon plugins that declare the key "X-Dolphin-ThreadSafe" in their metadata.
+    // Their overlays are loaded in batches on a worker thread, as plugins of sync
+    // clients or version control systems might need to perform I/O for each item.
+    QList<KOverlayIconPlugin *> m_threadSafeOverlayIconPlugins;
+
+    // URLs of the items whose overlays from m_threadSafeOverlayIconPlugins
+    // are queued or are being loaded by m_overlaysWatcher.
+    QList<QUrl> m_pendingOverlayUrls;
+    QList<QUrl> m_loadingOverlayUrls;
+    // Last loaded overlays from m_threadSafeOverlayIconPlugins for each URL.
+    QHash<QUrl, QStringList> m_threadSafeOverlays;
+    QFutureWatcher<QList<QStringList>> *m_overlaysWatcher;
+
 #if HAVE_BALOO
     Baloo::FileMonitor *m_balooFileMonitor;
     Baloo::IndexerConfig m_balooConfig;
+
+    // URLs and local paths of the items whose Baloo roles are queued
+    // or are being loaded by m_balooRolesWatcher. The URL is used to find
+    // the item in the model, as it is not necessarily a file URL.
+    QList<QPair<QUrl, QString>> m_pendingBalooFiles;
+    QList<QPair<QUrl, QString>> m_loadingBalooFiles;
+    QFutureWatcher<QList<SmallHash>> *m_balooRolesWatcher;
 #endif
 };
 
@@ -46,6 +46,11 @@ KItemListContainerViewport::KItemListContainerViewport(QGraphicsScene *scene, QW
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setViewportMargins(0, 0, 0, 0);
     setFrameShape(QFrame::NoFrame);
+
+    // All visible item widgets are moved when scrolling or animating the layout.
+    // Instead of repainting each dirty region separately, one repaint of the
+    // bounding rectangle of all dirty regions is done per frame.
+    setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
 }
 
 void KItemListContainerViewport::wheelEvent(QWheelEvent *event)
@@ -65,7 +70,13 @@ KItemListContainer::KItemListContainer(KItemListController *controller, QWidget
     Q_ASSERT(controller);
     controller->setParent(this);
 
-    QGraphicsView *graphicsView = new KItemListContainerViewport(new QGraphicsScene(this), this);
+    // The scene only contains the visible item widgets, which are moved permanently
+    // while scrolling. Keeping a BSP index up to date for them is more expensive
+    // than iterating the few items when looking up the items at a position.
+    QGraphicsScene *scene = new QGraphicsScene(this);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    QGraphicsView *graphicsView = new KItemListContainerViewport(scene, this);
     setViewport(graphicsView);
 
     m_horizontalSmoothScroller = new KItemListSmoothScroller(horizontalScrollBar(), this);
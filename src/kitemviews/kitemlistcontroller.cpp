@@ -30,6 +30,12 @@
 #include <QTimer>
 #include <QTouchEvent>
 
+namespace
+{
+// Maximum number of levels that are expanded below the current item if the key "*" is pressed
+constexpr int SubtreeExpansionDepth = 8;
+}
+
 KItemListController::KItemListController(KItemModelBase *model, KItemListView *view, QObject *parent)
     : QObject(parent)
     , m_singleClickActivationEnforced(false)
@@ -283,6 +289,12 @@ bool KItemListController::keyPressEvent(QKeyEvent *event)
         }
     }
 
+    // Expand all directories below the current directory, unless "*" is part of a keyboard search
+    if (m_view->supportsItemExpanding() && key == Qt::Key_Asterisk && !m_keyboardManager->isSearchAsYouTypeActive()
+        && m_model->expandSubtree(index, SubtreeExpansionDepth)) {
+        return true;
+    }
+
     const bool controlPressed = event->modifiers() & Qt::ControlModifier;
     if (m_selectionMode && !controlPressed && !shiftPressed && (key == Qt::Key_Enter || key == Qt::Key_Return)) {
         key = Qt::Key_Space; // In selection mode one moves around with arrow keys and toggles selection with Enter.
@@ -400,6 +400,8 @@ private:
      */
     int m_keyboardAnchorIndex;
     qreal m_keyboardAnchorPos;
+
+    friend class KItemListViewBenchmark;
 };
 
 #endif
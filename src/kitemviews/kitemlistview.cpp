@@ -24,14 +24,17 @@
 #include "private/kitemlistrubberband.h"
 #include "private/kitemlistsizehintresolver.h"
 #include "private/kitemlistviewlayouter.h"
+#include "private/kitemviewsutils.h"
 
 #include <QElapsedTimer>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
+#include <QPixmapCache>
 #include <QPropertyAnimation>
 #include <QStyleOptionRubberBand>
 #include <QTimer>
 #include <QVariantAnimation>
+#include <QtMath>
 
 namespace
 {
@@ -47,6 +50,19 @@ const int RubberFadeSpeed = 150;
 
 const char *RubberPropertyName = "_kitemviews_rubberBandPosition";
 
+// Time in ms without layout changes until widgets for recycling are created
+// in advance, and maximum number of widgets that are created at once
+const int WidgetPoolDelay = 200;
+const int WidgetPoolChunkSize = 16;
+
+// Minimum number of widgets that are kept for recycling
+const int MinimumRecycleableWidgets = 100;
+
+// Maximum size in kilobytes of the pixmaps that may be used for caching the
+// visible widgets. If more would be required, e.g. for a full-screen details
+// view on a high-DPI screen, the widgets are painted without cache.
+const int MaximumItemCacheSize = 64 * 1024;
+
 #ifndef QT_NO_ACCESSIBILITY
 QAccessibleInterface *accessibleInterfaceFactory(const QString &key, QObject *object)
 {
@@ -71,6 +87,8 @@ QAccessibleInterface *accessibleInterfaceFactory(const QString &key, QObject *ob
 KItemListView::KItemListView(QGraphicsWidget *parent)
     : QGraphicsWidget(parent)
     , m_enabledSelectionToggles(false)
+    , m_itemCacheEnabled(true)
+    , m_itemCacheActive(false)
     , m_grouped(false)
     , m_highlightEntireRow(false)
     , m_alternateBackgrounds(false)
@@ -101,6 +119,7 @@ KItemListView::KItemListView(QGraphicsWidget *parent)
     , m_mousePos()
     , m_autoScrollIncrement(0)
     , m_autoScrollTimer(nullptr)
+    , m_widgetPoolTimer(nullptr)
     , m_header(nullptr)
     , m_headerWidget(nullptr)
     , m_indicatorAnimation(nullptr)
@@ -115,6 +134,10 @@ KItemListView::KItemListView(QGraphicsWidget *parent)
 
     m_layouter = new KItemListViewLayouter(m_sizeHintResolver, this);
 
+    m_widgetPoolTimer = new QTimer(this);
+    m_widgetPoolTimer->setSingleShot(true);
+    connect(m_widgetPoolTimer, &QTimer::timeout, this, &KItemListView::updateWidgetPool);
+
     m_animation = new KItemListViewAnimation(this);
     connect(m_animation, &KItemListViewAnimation::finished, this, &KItemListView::slotAnimationFinished);
     connect(m_animation, &KItemListViewAnimation::started, this, &KItemListView::slotAnimationStarted);
@@ -310,6 +333,19 @@ bool KItemListView::enabledSelectionToggles() const
     return m_enabledSelectionToggles;
 }
 
+void KItemListView::setItemCacheEnabled(bool enabled)
+{
+    if (m_itemCacheEnabled != enabled) {
+        m_itemCacheEnabled = enabled;
+        updateItemCacheMode();
+    }
+}
+
+bool KItemListView::itemCacheEnabled() const
+{
+    return m_itemCacheEnabled;
+}
+
 KItemListController *KItemListView::controller() const
 {
     return m_controller;
@@ -2109,9 +2145,66 @@ void KItemListView::doLayout(LayoutAnimationHint hint, int changedIndex, int cha
         }
     }
 
+    updateItemCacheMode();
+
+    m_widgetPoolTimer->start(WidgetPoolDelay);
+
     emitOffsetChanges();
 }
 
+void KItemListView::updateItemCacheMode()
+{
+    bool cacheActive = m_itemCacheEnabled;
+    if (cacheActive) {
+        // Each cached widget occupies a 32-bit pixmap of its size in device
+        // pixels in QPixmapCache. Twice the size of the visible widgets is
+        // reserved, so that the cached widgets don't evict each other or the
+        // other users of QPixmapCache while scrolling.
+        const qreal dpr = KItemViewsUtils::devicePixelRatio(this);
+        qint64 requiredSize = 0;
+        for (const KItemListWidget *widget : std::as_const(m_visibleItems)) {
+            const QSizeF widgetSize = widget->size() * dpr;
+            requiredSize += qint64(qCeil(widgetSize.width())) * qCeil(widgetSize.height()) * 4;
+        }
+        requiredSize = 2 * requiredSize / 1024;
+
+        if (requiredSize > MaximumItemCacheSize) {
+            cacheActive = false;
+        } else if (QPixmapCache::cacheLimit() < requiredSize) {
+            QPixmapCache::setCacheLimit(static_cast<int>(requiredSize));
+        }
+    }
+
+    if (m_itemCacheActive != cacheActive) {
+        m_itemCacheActive = cacheActive;
+
+        const QGraphicsItem::CacheMode cacheMode = cacheActive ? QGraphicsItem::DeviceCoordinateCache : QGraphicsItem::NoCache;
+        for (KItemListWidget *widget : std::as_const(m_visibleItems)) {
+            widget->setCacheMode(cacheMode);
+        }
+    }
+}
+
+void KItemListView::updateWidgetPool()
+{
+    if (!m_model || m_model->count() <= 0 || m_layouter->itemSize().height() < 1) {
+        return;
+    }
+
+    KItemListWidgetCreatorBase *creator = widgetCreator();
+    const int poolSize = m_layouter->maximumVisibleItems();
+    creator->setMaximumRecycleableWidgets(qMax(poolSize, MinimumRecycleableWidgets));
+
+    const int missingCount = poolSize - creator->recycleableWidgetCount();
+    if (missingCount > 0) {
+        creator->prewarm(this, qMin(missingCount, WidgetPoolChunkSize));
+        if (missingCount > WidgetPoolChunkSize) {
+            // Give other events a chance before creating the next widgets
+            m_widgetPoolTimer->start(0);
+        }
+    }
+}
+
 QList<int> KItemListView::recycleInvisibleItems(int firstVisibleIndex, int lastVisibleIndex, LayoutAnimationHint hint)
 {
     // Determine all items that are completely invisible and might be
@@ -2219,6 +2312,7 @@ KItemListWidget *KItemListView::createWidget(int index)
 {
     KItemListWidget *widget = widgetCreator()->create(this);
     widget->setFlag(QGraphicsItem::ItemStacksBehindParent);
+    widget->setCacheMode(m_itemCacheActive ? QGraphicsItem::DeviceCoordinateCache : QGraphicsItem::NoCache);
 
     m_visibleItems.insert(index, widget);
     m_visibleCells.insert(index, Cell());
@@ -2961,6 +3055,24 @@ KItemListCreatorBase::~KItemListCreatorBase()
     qDeleteAll(m_createdWidgets);
 }
 
+void KItemListCreatorBase::setMaximumRecycleableWidgets(int count)
+{
+    m_maximumRecycleableWidgets = count;
+    while (m_recycleableWidgets.count() > count) {
+        delete m_recycleableWidgets.takeFirst();
+    }
+}
+
+int KItemListCreatorBase::maximumRecycleableWidgets() const
+{
+    return m_maximumRecycleableWidgets;
+}
+
+int KItemListCreatorBase::recycleableWidgetCount() const
+{
+    return m_recycleableWidgets.count();
+}
+
 void KItemListCreatorBase::addCreatedWidget(QGraphicsWidget *widget)
 {
     m_createdWidgets.insert(widget);
@@ -2970,8 +3082,12 @@ void KItemListCreatorBase::pushRecycleableWidget(QGraphicsWidget *widget)
 {
     Q_ASSERT(m_createdWidgets.contains(widget));
     m_createdWidgets.remove(widget);
+    addRecycleableWidget(widget);
+}
 
-    if (m_recycleableWidgets.count() < 100) {
+void KItemListCreatorBase::addRecycleableWidget(QGraphicsWidget *widget)
+{
+    if (m_recycleableWidgets.count() < m_maximumRecycleableWidgets) {
         m_recycleableWidgets.append(widget);
         widget->setVisible(false);
     } else {
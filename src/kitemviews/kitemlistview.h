@@ -112,6 +112,18 @@ public:
     void setEnabledSelectionToggles(bool enabled);
     bool enabledSelectionToggles() const;
 
+    /**
+     * If set to true the item widgets are cached as pixmaps in device
+     * coordinates. Moving an unchanged widget while scrolling only
+     * requires drawing the pixmap instead of painting the text and
+     * icon again. The pixmaps are stored in QPixmapCache, whose limit gets
+     * raised as needed. If the visible widgets would require more than
+     * 64 MB, they are painted without cache. Per default the item cache is
+     * enabled.
+     */
+    void setItemCacheEnabled(bool enabled);
+    bool itemCacheEnabled() const;
+
     /**
      * @return Controller of the item-list. The controller gets
      *         initialized by KItemListController::setView() and will
@@ -458,6 +470,21 @@ private Q_SLOTS:
     void slotRubberBandPosChanged();
     void slotRubberBandActivationChanged(bool active);
 
+    /**
+     * Creates widgets in advance until the widget creator keeps as many
+     * widgets for recycling as items can be visible. Is invoked if the
+     * layout has not been changed for a while, so that no widgets must be
+     * created while scrolling or zooming.
+     */
+    void updateWidgetPool();
+
+    /**
+     * Enables the cache of the visible widgets if the item cache is enabled
+     * and the pixmaps for the visible widgets fit into the memory budget.
+     * @see setItemCacheEnabled()
+     */
+    void updateItemCacheMode();
+
     /**
      * Is invoked if the column-width of one role in the header has
      * been changed by the user. The automatic resizing of columns
@@ -738,6 +765,8 @@ private:
 
 private:
     bool m_enabledSelectionToggles;
+    bool m_itemCacheEnabled;
+    bool m_itemCacheActive; // True if the widgets are cached within the memory budget
     bool m_grouped;
     bool m_highlightEntireRow;
     bool m_alternateBackgrounds;
@@ -806,6 +835,8 @@ private:
     int m_autoScrollIncrement;
     QTimer *m_autoScrollTimer;
 
+    QTimer *m_widgetPoolTimer;
+
     KItemListHeader *m_header;
     KItemListHeaderWidget *m_headerWidget;
 
@@ -833,6 +864,7 @@ private:
     friend class KItemListDelegateAccessible;
 
     friend class DolphinMainWindowTest;
+    friend class KItemListViewBenchmark;
 };
 
 /**
@@ -846,14 +878,33 @@ class DOLPHIN_EXPORT KItemListCreatorBase
 public:
     virtual ~KItemListCreatorBase();
 
+    /**
+     * Sets the maximum number of widgets that are kept for recycling.
+     * Widgets that are recycled beyond this number get deleted. Default is 100.
+     */
+    void setMaximumRecycleableWidgets(int count);
+    int maximumRecycleableWidgets() const;
+
+    /**
+     * @return Number of widgets that are kept for recycling.
+     */
+    int recycleableWidgetCount() const;
+
 protected:
     void addCreatedWidget(QGraphicsWidget *widget);
     void pushRecycleableWidget(QGraphicsWidget *widget);
     QGraphicsWidget *popRecycleableWidget();
 
+    /**
+     * Adds the new \a widget, which has not been used yet, to the widgets
+     * that are kept for recycling.
+     */
+    void addRecycleableWidget(QGraphicsWidget *widget);
+
 private:
     QSet<QGraphicsWidget *> m_createdWidgets;
     QList<QGraphicsWidget *> m_recycleableWidgets;
+    int m_maximumRecycleableWidgets = 100;
 };
 
 /**
@@ -874,6 +925,11 @@ public:
 
     virtual void recycle(KItemListWidget *widget);
 
+    /**
+     * Creates \a count widgets for \a view in advance and keeps them for recycling.
+     */
+    virtual void prewarm(KItemListView *view, int count) = 0;
+
     virtual void calculateItemSizeHints(QVector<std::pair<qreal, bool>> &logicalHeightHints, qreal &logicalWidthHint, const KItemListView *view) const = 0;
 
     virtual qreal preferredRoleColumnWidth(const QByteArray &role, int index, const KItemListView *view) const = 0;
@@ -894,6 +950,8 @@ public:
 
     KItemListWidget *create(KItemListView *view) override;
 
+    void prewarm(KItemListView *view, int count) override;
+
     void calculateItemSizeHints(QVector<std::pair<qreal, bool>> &logicalHeightHints, qreal &logicalWidthHint, const KItemListView *view) const override;
 
     qreal preferredRoleColumnWidth(const QByteArray &role, int index, const KItemListView *view) const override;
@@ -926,6 +984,15 @@ KItemListWidget *KItemListWidgetCreator<T>::create(KItemListView *view)
     return widget;
 }
 
+template<class T>
+void KItemListWidgetCreator<T>::prewarm(KItemListView *view, int count)
+{
+    Q_UNUSED(view)
+    for (int i = 0; i < count; ++i) {
+        addRecycleableWidget(new T(m_informant, nullptr));
+    }
+}
+
 template<class T>
 void KItemListWidgetCreator<T>::calculateItemSizeHints(QVector<std::pair<qreal, bool>> &logicalHeightHints,
                                                        qreal &logicalWidthHint,
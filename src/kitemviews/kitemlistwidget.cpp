@@ -77,6 +77,12 @@ int KItemListWidget::index() const
 
 void KItemListWidget::setData(const SmallHash &data, const QSet<QByteArray> &roles)
 {
+    if (roles.isEmpty() && data == m_data) {
+        // Keep the caches of the widget, e.g. if a recycled widget is used
+        // again for the item it has shown before.
+        return;
+    }
+
     clearHoverCache();
     if (roles.isEmpty()) {
         m_data = data;
@@ -151,6 +157,10 @@ void KItemListWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
 
 void KItemListWidget::setVisibleRoles(const QList<QByteArray> &roles)
 {
+    if (m_visibleRoles == roles) {
+        return;
+    }
+
     const QList<QByteArray> previousRoles = m_visibleRoles;
     m_visibleRoles = roles;
 
@@ -117,6 +117,13 @@ bool KItemModelBase::setExpanded(int index, bool expanded)
     return false;
 }
 
+bool KItemModelBase::expandSubtree(int index, int maximumDepth)
+{
+    Q_UNUSED(index)
+    Q_UNUSED(maximumDepth)
+    return false;
+}
+
 bool KItemModelBase::isExpanded(int index) const
 {
     Q_UNUSED(index)
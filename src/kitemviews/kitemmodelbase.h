@@ -115,6 +115,16 @@ public:
      */
     virtual bool setExpanded(int index, bool expanded);
 
+    /**
+     * Expands the item with the index \a index and all its expandable
+     * children up to \a maximumDepth levels below the item.
+     *
+     * Per default no expanding of items is implemented, see KItemModelBase::setExpanded().
+     *
+     * @return True if the operation has been started successfully.
+     */
+    virtual bool expandSubtree(int index, int maximumDepth);
+
     /**
      * @return True if the item with the index \a index is expanded.
      *         Per default no expanding of items is implemented. When implementing
@@ -9,6 +9,8 @@
 #include "dolphin_contentdisplaysettings.h"
 #include "kfileitemlistview.h"
 #include "private/kfileitemclipboard.h"
+#include "private/kitemlisthoversequencecache.h"
+#include "private/kitemlisticoncache.h"
 #include "private/kitemlistroleeditor.h"
 #include "private/kitemviewsutils.h"
 #include "private/kpixmapmodifier.h"
@@ -24,7 +26,6 @@
 #include <QGraphicsScene>
 #include <QGraphicsSceneResizeEvent>
 #include <QGraphicsView>
-#include <QPixmapCache>
 #include <QStyleOption>
 #include <QTextBoundaryFinder>
 #include <QVariantAnimation>
@@ -349,50 +350,9 @@ void KStandardItemListWidget::paint(QPainter *painter, const QStyleOptionGraphic
     const auto pixmap = m_pixmap;
 
     const KItemListStyleOption &itemListStyleOption = styleOption();
-    if (isHovered() && !pixmap.isNull()) {
-        if (hoverOpacity() < 1.0) {
-            /*
-             * Linear interpolation between pixmap and m_hoverPixmap.
-             *
-             * Note that this cannot be achieved by painting m_hoverPixmap over
-             * pixmap, even if the opacities are adjusted. For details see
-             * https://git.reviewboard.kde.org/r/109614/
-             */
-            // Paint pixmap1 so that pixmap1 = pixmap * (1.0 - hoverOpacity())
-            QPixmap pixmap1(pixmap.size());
-            pixmap1.setDevicePixelRatio(pixmap.devicePixelRatio());
-            pixmap1.fill(Qt::transparent);
-            {
-                QPainter p(&pixmap1);
-                p.setOpacity(1.0 - hoverOpacity());
-                p.drawPixmap(0, 0, pixmap);
-            }
-
-            // Paint pixmap2 so that pixmap2 = m_hoverPixmap * hoverOpacity()
-            QPixmap pixmap2(pixmap1.size());
-            pixmap2.setDevicePixelRatio(pixmap1.devicePixelRatio());
-            pixmap2.fill(Qt::transparent);
-            {
-                QPainter p(&pixmap2);
-                p.setOpacity(hoverOpacity());
-                p.drawPixmap(0, 0, m_pixmap);
-            }
-
-            // Paint pixmap2 on pixmap1 using CompositionMode_Plus
-            // Now pixmap1 = pixmap2 + pixmap * (1.0 - hoverOpacity())
-            //             = m_hoverPixmap * hoverOpacity() + pixmap * (1.0 - hoverOpacity())
-            {
-                QPainter p(&pixmap1);
-                p.setCompositionMode(QPainter::CompositionMode_Plus);
-                p.drawPixmap(0, 0, pixmap2);
-            }
-
-            // Finally paint pixmap1 on the widget
-            drawPixmap(painter, pixmap1);
-        } else {
-            drawPixmap(painter, pixmap);
-        }
-    } else if (!pixmap.isNull()) {
+    // The icon looks the same whether the item is hovered or not, the hover
+    // state is only indicated by the background. So no cross-fading is required.
+    if (!pixmap.isNull()) {
         drawPixmap(painter, pixmap);
     }
 
@@ -959,6 +919,10 @@ bool KStandardItemListWidget::event(QEvent *event)
         if (isPressed()) {
             invalidateIconCache();
         }
+        if (cacheMode() != QGraphicsItem::NoCache) {
+            // The colors depend on whether the window is active.
+            update();
+        }
     } else if (event->type() == QEvent::PaletteChange) {
         m_dirtyContent = true;
     }
@@ -1104,12 +1068,10 @@ void KStandardItemListWidget::updatePixmapCache()
 
         int sequenceIndex = hoverSequenceIndex();
 
-        if (values.contains("hoverSequencePixmaps") && !isIconControlledByActivateSoonAnimation()) {
+        if (sequenceIndex > 0 && !isIconControlledByActivateSoonAnimation()) {
             // Use one of the hover sequence pixmaps instead of the default
             // icon pixmap.
 
-            const QVector<QPixmap> pixmaps = values["hoverSequencePixmaps"].value<QVector<QPixmap>>();
-
             if (values.contains("hoverSequenceWraparoundPoint")) {
                 const float wap = values["hoverSequenceWraparoundPoint"].toFloat();
                 if (wap >= 1.0f) {
@@ -1117,11 +1079,9 @@ void KStandardItemListWidget::updatePixmapCache()
                 }
             }
 
-            const int loadedIndex = qMax(qMin(sequenceIndex, pixmaps.size() - 1), 0);
-
-            if (loadedIndex != 0) {
-                m_pixmap = pixmaps[loadedIndex];
-            }
+            // Returns the last loaded frame if the frame for sequenceIndex has not been loaded yet
+            const QSize frameSize = QSize(maxIconWidth, maxIconHeight) * dpr;
+            m_pixmap = KItemListHoverSequenceCache::instance()->frame(values["url"].toUrl(), frameSize, sequenceIndex);
         }
 
         if (m_pixmap.isNull() && !isIconControlledByActivateSoonAnimation()) {
@@ -1744,36 +1704,7 @@ void KStandardItemListWidget::closeRoleEditor()
 
 QPixmap KStandardItemListWidget::pixmapForIcon(const QString &name, const QSize &size, QIcon::Mode mode) const
 {
-    static const QIcon fallbackIcon = QIcon::fromTheme(QStringLiteral("unknown"));
-    const qreal dpr = KItemViewsUtils::devicePixelRatio(this);
-
-    int iconHeight = size.height();
-    QSize iconSize = QSize(iconHeight, iconHeight);
-
-    const QString key = "KStandardItemListWidget:" % name % ":" % QString::number(iconHeight) % "@" % QString::number(dpr) % ":" % QString::number(mode);
-    QPixmap pixmap;
-
-    if (!QPixmapCache::find(key, &pixmap)) {
-        QIcon icon = QIcon::fromTheme(name);
-        if (icon.isNull()) {
-            icon = QIcon(name);
-        }
-        if (!icon.isNull()) {
-            pixmap = icon.pixmap(iconSize, dpr, mode);
-        }
-        if (pixmap.isNull()) {
-            icon = fallbackIcon;
-            pixmap = icon.pixmap(iconSize, dpr, mode);
-        }
-        if (pixmap.width() != iconHeight * dpr || pixmap.height() != iconHeight * dpr) {
-            KPixmapModifier::scale(pixmap, iconSize * dpr);
-        }
-
-        QPixmapCache::insert(key, pixmap);
-    }
-    pixmap.setDevicePixelRatio(dpr);
-
-    return pixmap;
+    return KItemListIconCache::instance()->pixmap(name, size.height(), KItemViewsUtils::devicePixelRatio(this), mode);
 }
 
 QSizeF KStandardItemListWidget::preferredRatingSize(const KItemListStyleOption &option)
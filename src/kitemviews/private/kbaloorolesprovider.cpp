@@ -177,6 +177,20 @@ SmallHash KBalooRolesProvider::roleValues(const Baloo::File &file, const QSet<QB
     return values;
 }
 
+QList<SmallHash> KBalooRolesProvider::roleValues(const QStringList &paths, const QSet<QByteArray> &roles) const
+{
+    QList<SmallHash> result;
+    result.reserve(paths.count());
+
+    for (const QString &path : paths) {
+        Baloo::File file(path);
+        file.load();
+        result.append(roleValues(file, roles));
+    }
+
+    return result;
+}
+
 KBalooRolesProvider::KBalooRolesProvider()
 {
     // Display roles filled from Baloo property cache
@@ -13,6 +13,7 @@
 
 #include <QHash>
 #include <QSet>
+#include <QStringList>
 #include <QVariant>
 
 namespace Baloo
@@ -43,6 +44,14 @@ public:
      */
     SmallHash roleValues(const Baloo::File &file, const QSet<QByteArray> &roles) const;
 
+    /**
+     * Loads the Baloo data of the files with the local paths \a paths.
+     * Can be invoked on a worker thread to load the data of several items
+     * without blocking the GUI thread.
+     * @return Values for the roles \a roles for each file of \a paths.
+     */
+    QList<SmallHash> roleValues(const QStringList &paths, const QSet<QByteArray> &roles) const;
+
 protected:
     KBalooRolesProvider();
 
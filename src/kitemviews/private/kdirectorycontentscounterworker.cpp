@@ -7,6 +7,8 @@
 
 #include "kdirectorycontentscounterworker.h"
 
+#include "dolphintrace.h"
+
 // Required includes for countDirectoryContents():
 #if defined(Q_OS_WIN) || defined(Q_OS_HAIKU)
 #include <QDir>
@@ -26,6 +28,8 @@ KDirectoryContentsCounterWorker::KDirectoryContentsCounterWorker(QObject *parent
 #if !defined(Q_OS_WIN) && !defined(Q_OS_HAIKU)
 void KDirectoryContentsCounterWorker::walkDir(const QString &dirPath, bool countHiddenFiles, uint allowedRecursiveLevel)
 {
+    DolphinTraceSpan span("KDirectoryContentsCounterWorker::walkDir");
+
     QByteArray text = dirPath.toLocal8Bit();
     char *rootPath = new char[text.size() + 1];
     ::strncpy(rootPath, text.constData(), text.size() + 1);
@@ -113,6 +117,7 @@ void KDirectoryContentsCounterWorker::walkDir(const QString &dirPath, bool count
         return;
     }
 
+    span.setCount(totalCount);
     if (!m_stopping) {
         Q_EMIT result(dirPath, totalCount, totalSize);
     }
@@ -0,0 +1,151 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemlisthoversequencecache.h"
+
+#include <QBuffer>
+#include <QImage>
+
+#include <algorithm>
+
+namespace
+{
+// Default maximum size of the encoded frames in kilobytes
+constexpr int DefaultMaximumSize = 16 * 1024;
+
+// Quality of the frames that are encoded as JPEG
+constexpr int FrameQuality = 85;
+
+int costOf(int byteCount)
+{
+    return std::max(byteCount / 1024, 1);
+}
+}
+
+class KItemListHoverSequenceCacheSingleton
+{
+public:
+    KItemListHoverSequenceCache instance;
+};
+Q_GLOBAL_STATIC(KItemListHoverSequenceCacheSingleton, s_KItemListHoverSequenceCache)
+
+KItemListHoverSequenceCache::KItemListHoverSequenceCache()
+    : m_frames(DefaultMaximumSize)
+{
+}
+
+KItemListHoverSequenceCache *KItemListHoverSequenceCache::instance()
+{
+    return &s_KItemListHoverSequenceCache->instance;
+}
+
+int KItemListHoverSequenceCache::frameCount(const QUrl &url, const QSize &frameSize, const QDateTime &modificationTime)
+{
+    const Key key{url, frameSize};
+    const Frames *frames = m_frames.object(key);
+    if (!frames) {
+        return 0;
+    }
+
+    if (frames->modificationTime != modificationTime) {
+        // The item has been changed since the frames have been generated.
+        m_frames.remove(key);
+        return 0;
+    }
+
+    return frames->encodedFrames.count();
+}
+
+void KItemListHoverSequenceCache::appendFrame(const QUrl &url, const QSize &frameSize, const QDateTime &modificationTime, const QPixmap &pixmap)
+{
+    // The cost of an object in QCache cannot be changed, so
+    // the frames are taken out of the cache and inserted again.
+    const Key key{url, frameSize};
+    Frames *frames = m_frames.take(key);
+    if (!frames || frames->modificationTime != modificationTime) {
+        delete frames;
+        frames = new Frames;
+        frames->modificationTime = modificationTime;
+    }
+
+    const QByteArray encodedFrame = encode(pixmap);
+    if (!pixmap.isNull()) {
+        frames->devicePixelRatio = pixmap.devicePixelRatio();
+    }
+    frames->encodedFrames.append(encodedFrame);
+    frames->byteCount += encodedFrame.size();
+
+    m_frames.insert(key, frames, costOf(frames->byteCount));
+}
+
+QPixmap KItemListHoverSequenceCache::frame(const QUrl &url, const QSize &frameSize, int sequenceIndex)
+{
+    const Frames *frames = m_frames.object(Key{url, frameSize});
+    if (!frames || frames->encodedFrames.isEmpty() || sequenceIndex < 1) {
+        return QPixmap();
+    }
+
+    const int frameIndex = std::min<int>(sequenceIndex, frames->encodedFrames.count()) - 1;
+    const QByteArray &encodedFrame = frames->encodedFrames.at(frameIndex);
+    if (encodedFrame.isEmpty()) {
+        return QPixmap();
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(QImage::fromData(encodedFrame));
+    pixmap.setDevicePixelRatio(frames->devicePixelRatio);
+    return pixmap;
+}
+
+void KItemListHoverSequenceCache::remove(const QUrl &url)
+{
+    const QList<Key> keys = m_frames.keys();
+    for (const Key &key : keys) {
+        if (key.url == url) {
+            m_frames.remove(key);
+        }
+    }
+}
+
+void KItemListHoverSequenceCache::setMaximumSize(int kiloBytes)
+{
+    m_frames.setMaxCost(kiloBytes);
+}
+
+int KItemListHoverSequenceCache::maximumSize() const
+{
+    return m_frames.maxCost();
+}
+
+int KItemListHoverSequenceCache::size() const
+{
+    return m_frames.totalCost();
+}
+
+void KItemListHoverSequenceCache::clear()
+{
+    m_frames.clear();
+}
+
+QByteArray KItemListHoverSequenceCache::encode(const QPixmap &pixmap)
+{
+    QByteArray encodedFrame;
+    if (pixmap.isNull()) {
+        return encodedFrame;
+    }
+
+    const QImage image = pixmap.toImage();
+    QBuffer buffer(&encodedFrame);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.hasAlphaChannel() && image.save(&buffer, "JPG", FrameQuality)) {
+        return encodedFrame;
+    }
+
+    // Opening the buffer again truncates the partially written JPEG data
+    buffer.close();
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return encodedFrame;
+}
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KITEMLISTHOVERSEQUENCECACHE_H
+#define KITEMLISTHOVERSEQUENCECACHE_H
+
+#include "dolphin_export.h"
+
+#include <QByteArray>
+#include <QCache>
+#include <QDateTime>
+#include <QList>
+#include <QPixmap>
+#include <QSize>
+#include <QUrl>
+
+/**
+ * @brief Cache for the frames of the hover sequence previews.
+ *
+ * The hover sequence previews are shown if the mouse hovers over an item
+ * whose thumbnailer supports sequences, e.g. videos. The frames are stored
+ * encoded as JPEG or, if they have an alpha channel, as PNG and are decoded
+ * on demand. The frames of the least recently used items are removed if the
+ * cache exceeds its maximum size.
+ *
+ * The cache is shared by all views, so that the frames of an item are
+ * only generated once. As the views may use different icon sizes, the
+ * frames are stored per frame size in device pixels.
+ */
+class DOLPHIN_EXPORT KItemListHoverSequenceCache
+{
+public:
+    static KItemListHoverSequenceCache *instance();
+
+    /**
+     * @return Number of frames with the size \a frameSize that are available
+     *         for the item \a url. If the frames have been generated for another
+     *         modification time than \a modificationTime, they are removed and
+     *         0 is returned.
+     */
+    int frameCount(const QUrl &url, const QSize &frameSize, const QDateTime &modificationTime);
+
+    /**
+     * Appends the frame \a pixmap to the frames with the size \a frameSize of
+     * the item \a url. The frame gets the sequence index frameCount() + 1, as
+     * the sequence index 0 is used by the regular preview.
+     */
+    void appendFrame(const QUrl &url, const QSize &frameSize, const QDateTime &modificationTime, const QPixmap &pixmap);
+
+    /**
+     * @return Frame with the sequence index \a sequenceIndex and the size
+     *         \a frameSize of the item \a url. If the frame is not available
+     *         yet, the last available frame is returned. If no frame is
+     *         available, a null pixmap is returned.
+     */
+    QPixmap frame(const QUrl &url, const QSize &frameSize, int sequenceIndex);
+
+    /**
+     * Removes the frames of all sizes of the item \a url.
+     */
+    void remove(const QUrl &url);
+
+    /**
+     * Sets the maximum size of the encoded frames in kilobytes.
+     */
+    void setMaximumSize(int kiloBytes);
+    int maximumSize() const;
+
+    /**
+     * @return Size of the encoded frames in kilobytes.
+     */
+    int size() const;
+
+    void clear();
+
+private:
+    KItemListHoverSequenceCache();
+
+    struct Key {
+        QUrl url;
+        QSize frameSize;
+
+        bool operator==(const Key &other) const
+        {
+            return url == other.url && frameSize == other.frameSize;
+        }
+
+        friend size_t qHash(const Key &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.url, key.frameSize.width(), key.frameSize.height());
+        }
+    };
+
+    struct Frames {
+        QDateTime modificationTime;
+        qreal devicePixelRatio = 1.0;
+        QList<QByteArray> encodedFrames;
+        int byteCount = 0;
+    };
+
+    static QByteArray encode(const QPixmap &pixmap);
+
+    QCache<Key, Frames> m_frames;
+
+    friend class KItemListHoverSequenceCacheSingleton;
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemlisticoncache.h"
+
+#include "kpixmapmodifier.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+
+namespace
+{
+// Default maximum size of the cache in kilobytes
+constexpr int DefaultMaximumSize = 32 * 1024;
+}
+
+class KItemListIconCacheSingleton
+{
+public:
+    KItemListIconCache instance;
+};
+Q_GLOBAL_STATIC(KItemListIconCacheSingleton, s_KItemListIconCache)
+
+size_t qHash(const KItemListIconCache::Key &key, size_t seed)
+{
+    return qHashMulti(seed, key.nameId, key.size, key.devicePixelRatio, static_cast<int>(key.mode));
+}
+
+KItemListIconCache::KItemListIconCache()
+    : m_themeName(QIcon::themeName())
+    , m_nameIds()
+    , m_pixmaps(DefaultMaximumSize)
+{
+    // The cache is destroyed after the application, but pixmaps
+    // must not outlive QGuiApplication.
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() {
+            clear();
+        });
+    }
+}
+
+KItemListIconCache *KItemListIconCache::instance()
+{
+    return &s_KItemListIconCache->instance;
+}
+
+QPixmap KItemListIconCache::pixmap(const QString &name, int size, qreal devicePixelRatio, QIcon::Mode mode)
+{
+    updateThemeName();
+
+    auto it = m_nameIds.constFind(name);
+    if (it == m_nameIds.constEnd()) {
+        it = m_nameIds.insert(name, m_nameIds.count());
+    }
+
+    const Key key{*it, size, devicePixelRatio, mode};
+    if (const QPixmap *cachedPixmap = m_pixmaps.object(key)) {
+        return *cachedPixmap;
+    }
+
+    const QPixmap pixmap = loadPixmap(name, size, devicePixelRatio, mode);
+    const qint64 cost = qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024;
+    m_pixmaps.insert(key, new QPixmap(pixmap), std::max<qint64>(cost, 1));
+    return pixmap;
+}
+
+void KItemListIconCache::prewarm(const QStringList &names, int size, qreal devicePixelRatio, QIcon::Mode mode)
+{
+    for (const QString &name : names) {
+        pixmap(name, size, devicePixelRatio, mode);
+    }
+}
+
+void KItemListIconCache::setMaximumSize(int kiloBytes)
+{
+    m_pixmaps.setMaxCost(kiloBytes);
+}
+
+int KItemListIconCache::maximumSize() const
+{
+    return m_pixmaps.maxCost();
+}
+
+int KItemListIconCache::count() const
+{
+    return m_pixmaps.count();
+}
+
+void KItemListIconCache::clear()
+{
+    m_pixmaps.clear();
+    m_nameIds.clear();
+}
+
+void KItemListIconCache::updateThemeName()
+{
+    const QString themeName = QIcon::themeName();
+    if (themeName != m_themeName) {
+        m_themeName = themeName;
+        clear();
+    }
+}
+
+QPixmap KItemListIconCache::loadPixmap(const QString &name, int size, qreal devicePixelRatio, QIcon::Mode mode)
+{
+    static const QIcon fallbackIcon = QIcon::fromTheme(QStringLiteral("unknown"));
+    const QSize iconSize(size, size);
+
+    QPixmap pixmap;
+    QIcon icon = QIcon::fromTheme(name);
+    if (icon.isNull()) {
+        icon = QIcon(name);
+    }
+    if (!icon.isNull()) {
+        pixmap = icon.pixmap(iconSize, devicePixelRatio, mode);
+    }
+    if (pixmap.isNull()) {
+        pixmap = fallbackIcon.pixmap(iconSize, devicePixelRatio, mode);
+    }
+    if (pixmap.width() != size * devicePixelRatio || pixmap.height() != size * devicePixelRatio) {
+        KPixmapModifier::scale(pixmap, iconSize * devicePixelRatio);
+    }
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+
+    return pixmap;
+}
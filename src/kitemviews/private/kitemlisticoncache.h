@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KITEMLISTICONCACHE_H
+#define KITEMLISTICONCACHE_H
+
+#include "dolphin_export.h"
+
+#include <QCache>
+#include <QHash>
+#include <QIcon>
+#include <QPixmap>
+#include <QString>
+
+/**
+ * @brief Cache for the pixmaps of themed icons shown by the item views.
+ *
+ * The pixmaps are identified by the icon name, the size, the device pixel
+ * ratio and the mode. The icon names are interned, so that a lookup only
+ * requires hashing a few numbers. The least recently used pixmaps are removed
+ * if the cache exceeds its maximum size, independent of the QPixmapCache limit.
+ *
+ * The cache is cleared if the icon theme changes and when the application
+ * is about to quit.
+ */
+class DOLPHIN_EXPORT KItemListIconCache
+{
+public:
+    static KItemListIconCache *instance();
+
+    /**
+     * @return Pixmap of the icon \a name with the size \a size in
+     *         device-independent pixels. If the icon cannot be found,
+     *         the icon "unknown" is returned.
+     */
+    QPixmap pixmap(const QString &name, int size, qreal devicePixelRatio, QIcon::Mode mode = QIcon::Normal);
+
+    /**
+     * Loads the pixmaps of the icons \a names if they are not cached yet.
+     */
+    void prewarm(const QStringList &names, int size, qreal devicePixelRatio, QIcon::Mode mode = QIcon::Normal);
+
+    /**
+     * Sets the maximum size of the cache in kilobytes.
+     */
+    void setMaximumSize(int kiloBytes);
+    int maximumSize() const;
+
+    int count() const;
+    void clear();
+
+private:
+    KItemListIconCache();
+
+    struct Key {
+        int nameId;
+        int size;
+        qreal devicePixelRatio;
+        QIcon::Mode mode;
+
+        bool operator==(const Key &other) const = default;
+    };
+    friend size_t qHash(const Key &key, size_t seed);
+
+    void updateThemeName();
+    static QPixmap loadPixmap(const QString &name, int size, qreal devicePixelRatio, QIcon::Mode mode);
+
+    QString m_themeName;
+    QHash<QString, int> m_nameIds;
+    QCache<Key, QPixmap> m_pixmaps;
+
+    friend class KItemListIconCacheSingleton;
+};
+
+#endif
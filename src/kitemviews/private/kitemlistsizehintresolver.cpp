@@ -5,6 +5,7 @@
  */
 
 #include "kitemlistsizehintresolver.h"
+#include "dolphintrace.h"
 #include "kitemviews/kitemlistview.h"
 
 KItemListSizeHintResolver::KItemListSizeHintResolver(const KItemListView *itemListView)
@@ -144,6 +145,7 @@ void KItemListSizeHintResolver::clearCache()
 void KItemListSizeHintResolver::updateCache()
 {
     if (m_needsResolving) {
+        const DolphinTraceSpan span("KItemListSizeHintResolver::updateCache", m_logicalHeightHintCache.count());
         m_itemListView->calculateItemSizeHints(m_logicalHeightHintCache, m_logicalWidthHint);
         m_needsResolving = false;
     }
@@ -5,15 +5,14 @@
  */
 
 #include "kitemlistviewlayouter.h"
-#include "dolphindebug.h"
+
+#include "dolphintrace.h"
 #include "kitemlistsizehintresolver.h"
 #include "kitemviews/kitemmodelbase.h"
 
 #include <QGuiApplication>
 #include <QScopeGuard>
 
-// #define KITEMLISTVIEWLAYOUTER_DEBUG
-
 KItemListViewLayouter::KItemListViewLayouter(KItemListSizeHintResolver *sizeHintResolver, QObject *parent)
     : QObject(parent)
     , m_dirty(true)
@@ -410,10 +409,7 @@ void KItemListViewLayouter::doLayout()
         return;
     }
 
-#ifdef KITEMLISTVIEWLAYOUTER_DEBUG
-    QElapsedTimer timer;
-    timer.start();
-#endif
+    const DolphinTraceSpan span("KItemListViewLayouter::doLayout", m_model->count());
     m_visibleIndexesDirty = true;
 
     QSizeF itemSize = m_itemSize;
@@ -603,9 +599,6 @@ void KItemListViewLayouter::doLayout()
         m_maximumItemOffset = 0;
     }
 
-#ifdef KITEMLISTVIEWLAYOUTER_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] doLayout() for " << m_model->count() << "items:" << timer.elapsed();
-#endif
     m_dirty = false;
 }
 
@@ -17,6 +17,7 @@
 #if HAVE_KUSERFEEDBACK
 #include "userfeedback/dolphinfeedbackprovider.h"
 #endif
+#include "views/viewproperties.h"
 
 #include <KAboutData>
 #include <KConfigGui>
@@ -216,6 +217,10 @@ int main(int argc, char **argv)
         urls.append(urls.last());
     }
 
+    // Changing several view properties in a row, e.g. by zooming, should
+    // not write the properties of the directory each time.
+    ViewProperties::setDelayedSavingEnabled(true);
+
     DolphinMainWindow *mainWindow = new DolphinMainWindow();
 
     if (openFiles) {
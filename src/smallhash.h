@@ -105,6 +105,11 @@ public:
         return m_data.end();
     }
 
+    bool operator==(const SmallHash &other) const
+    {
+        return m_data == other.m_data;
+    }
+
 private:
     int indexOf(const QByteArray &key) const
     {
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "benchmarkitemgenerator.h"
+
+#include <KIO/UDSEntry>
+
+#include <sys/stat.h>
+
+namespace
+{
+struct FileType {
+    const char *extension;
+    const char *mimeType;
+};
+
+const FileType FileTypes[] = {
+    {"txt", "text/plain"},
+    {"pdf", "application/pdf"},
+    {"odt", "application/vnd.oasis.opendocument.text"},
+    {"jpg", "image/jpeg"},
+    {"png", "image/png"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/x-vorbis+ogg"},
+    {"mkv", "video/x-matroska"},
+    {"mp4", "video/mp4"},
+    {"zip", "application/zip"},
+    {"tar.gz", "application/x-compressed-tar"},
+    {"cpp", "text/x-c++src"},
+    {"h", "text/x-chdr"},
+    {"", "inode/directory"},
+};
+
+const QString DirectoryMimeType = QStringLiteral("inode/directory");
+
+// Fixed reference time for the modification times (2026-01-01 00:00 UTC),
+// so that they don't depend on the time when the benchmark is run.
+const qint64 ReferenceTime = 1767225600;
+
+void messageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    Q_UNUSED(context)
+
+    switch (type) {
+    case QtCriticalMsg:
+        fprintf(stderr, "Critical: %s\n", msg.toLocal8Bit().data());
+        break;
+    case QtFatalMsg:
+        fprintf(stderr, "Fatal: %s\n", msg.toLocal8Bit().data());
+        abort();
+    default:
+        break;
+    }
+}
+}
+
+BenchmarkItemGenerator::BenchmarkItemGenerator(quint32 seed)
+    : m_engine(seed)
+{
+}
+
+KFileItemList BenchmarkItemGenerator::naturalSortItems(const QUrl &directory, int count)
+{
+    KFileItemList items;
+    items.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        QString name;
+        const FileType *fileType = nullptr;
+        switch (random(0, 5)) {
+        case 0:
+            name = QStringLiteral("IMG_%1").arg(random(0, 9999), 4, 10, QLatin1Char('0'));
+            fileType = &FileTypes[3];
+            break;
+        case 1:
+            name = QStringLiteral("IMG_%1 (%2)").arg(random(0, 9999), 4, 10, QLatin1Char('0')).arg(random(1, 20));
+            fileType = &FileTypes[3];
+            break;
+        case 2:
+            name = QStringLiteral("Chapter %1 Part %2").arg(random(1, 200)).arg(random(1, 30));
+            fileType = &FileTypes[0];
+            break;
+        case 3:
+            name = QStringLiteral("report v%1.%2.%3 final").arg(random(0, 12)).arg(random(0, 40)).arg(random(0, 300));
+            fileType = &FileTypes[1];
+            break;
+        case 4:
+            name = QStringLiteral("Track %1 - Artist %2").arg(random(1, 99)).arg(random(1, 500));
+            fileType = &FileTypes[5];
+            break;
+        default:
+            name = QStringLiteral("file%1").arg(random(0, 1000000));
+            fileType = &FileTypes[0];
+            break;
+        }
+
+        // Make the names unique
+        name += QStringLiteral(" #%1.").arg(i) + QLatin1String(fileType->extension);
+
+        items.append(createItem(directory, name, QLatin1String(fileType->mimeType)));
+    }
+
+    return items;
+}
+
+KFileItemList BenchmarkItemGenerator::mixedMimeTypeItems(const QUrl &directory, int count)
+{
+    constexpr int fileTypeCount = sizeof(FileTypes) / sizeof(FileTypes[0]);
+
+    KFileItemList items;
+    items.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const FileType &fileType = FileTypes[random(0, fileTypeCount - 1)];
+        QString name = QStringLiteral("item %1").arg(i);
+        if (*fileType.extension) {
+            name += QLatin1Char('.') + QLatin1String(fileType.extension);
+        }
+        items.append(createItem(directory, name, QLatin1String(fileType.mimeType)));
+    }
+
+    return items;
+}
+
+QList<QPair<QUrl, KFileItemList>> BenchmarkItemGenerator::expandedTree(const QUrl &directory, int depth, int foldersPerFolder, int filesPerFolder)
+{
+    QList<QPair<QUrl, KFileItemList>> tree;
+    if (depth <= 0) {
+        return tree;
+    }
+
+    KFileItemList items;
+    for (int i = 0; i < foldersPerFolder; ++i) {
+        items.append(createItem(directory, QStringLiteral("folder %1").arg(i), DirectoryMimeType));
+    }
+    items.append(naturalSortItems(directory, filesPerFolder));
+    tree.append({directory, items});
+
+    for (int i = 0; i < foldersPerFolder; ++i) {
+        tree.append(expandedTree(items.at(i).url(), depth - 1, foldersPerFolder, filesPerFolder));
+    }
+
+    return tree;
+}
+
+void BenchmarkItemGenerator::suppressMessages()
+{
+    qInstallMessageHandler(messageOutput);
+}
+
+KFileItem BenchmarkItemGenerator::createItem(const QUrl &directory, const QString &name, const QString &mimeType)
+{
+    const bool isDir = (mimeType == DirectoryMimeType);
+
+    KIO::UDSEntry entry;
+    entry.reserve(6);
+    entry.fastInsert(KIO::UDSEntry::UDS_NAME, name);
+    entry.fastInsert(KIO::UDSEntry::UDS_FILE_TYPE, isDir ? S_IFDIR : S_IFREG);
+    entry.fastInsert(KIO::UDSEntry::UDS_ACCESS, isDir ? 0755 : 0644);
+    entry.fastInsert(KIO::UDSEntry::UDS_SIZE, isDir ? 0 : random(0, 100000000));
+    // Spread the modification times over the two years before the reference time
+    entry.fastInsert(KIO::UDSEntry::UDS_MODIFICATION_TIME, ReferenceTime - random(0, 2 * 365 * 24 * 60 * 60));
+    if (!mimeType.isEmpty()) {
+        entry.fastInsert(KIO::UDSEntry::UDS_MIME_TYPE, mimeType);
+    }
+
+    return KFileItem(entry, directory, true, true);
+}
+
+int BenchmarkItemGenerator::random(int min, int max)
+{
+    return std::uniform_int_distribution<int>(min, max)(m_engine);
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BENCHMARKITEMGENERATOR_H
+#define BENCHMARKITEMGENERATOR_H
+
+#include <KFileItem>
+
+#include <QList>
+#include <QPair>
+#include <QUrl>
+
+#include <random>
+
+/**
+ * BenchmarkItemGenerator creates synthetic items for benchmarks. The items do
+ * not exist on disk, but have a name, size, modification time and MIME type,
+ * so that they can be sorted, grouped and filtered without accessing the
+ * file system.
+ *
+ * The generated items only depend on the seed, so that the results of
+ * several benchmark runs can be compared.
+ */
+class BenchmarkItemGenerator
+{
+public:
+    explicit BenchmarkItemGenerator(quint32 seed = 42);
+
+    /**
+     * @return \a count files inside \a directory with names that contain
+     *         several numbers, like "IMG_0042 (3).jpg" or "Chapter 12 Part 3.txt",
+     *         which is the expensive case for the natural sorting.
+     */
+    KFileItemList naturalSortItems(const QUrl &directory, int count);
+
+    /**
+     * @return \a count files and folders inside \a directory with MIME types of
+     *         typical folders: documents, images, audio, videos, archives and source code.
+     */
+    KFileItemList mixedMimeTypeItems(const QUrl &directory, int count);
+
+    /**
+     * @return The contents of a tree of folders below \a directory with \a depth
+     *         levels. Each folder contains \a foldersPerFolder folders and
+     *         \a filesPerFolder files. The contents are ordered like they are
+     *         loaded when expanding all folders: a folder is listed before
+     *         its contents.
+     */
+    QList<QPair<QUrl, KFileItemList>> expandedTree(const QUrl &directory, int depth, int foldersPerFolder, int filesPerFolder);
+
+    /**
+     * Suppresses the debug output and warnings, e.g., about files that do not exist.
+     */
+    static void suppressMessages();
+
+private:
+    KFileItem createItem(const QUrl &directory, const QString &name, const QString &mimeType);
+    int random(int min, int max);
+
+private:
+    std::mt19937 m_engine;
+};
+
+#endif
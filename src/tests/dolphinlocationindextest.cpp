@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinlocationindex.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUrl>
+
+class DolphinLocationIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCompletions();
+    void testWeights();
+    void testRemoteUrls();
+    void testPersistence();
+};
+
+void DolphinLocationIndexTest::testCompletions()
+{
+    DolphinLocationIndex index;
+    index.addLocation(QUrl::fromLocalFile("/home/user/Documents"), DolphinLocationIndex::VisitedLocation);
+    index.addLocation(QUrl::fromLocalFile("/home/user/Downloads/"), DolphinLocationIndex::VisitedLocation);
+    index.addLocation(QUrl::fromLocalFile("/home/user/Music"), DolphinLocationIndex::VisitedLocation);
+    index.addLocation(QUrl::fromLocalFile("/media/archive"), DolphinLocationIndex::VisitedLocation);
+    QCOMPARE(index.count(), 4);
+
+    // Locations with equal weights are sorted alphabetically.
+    QCOMPARE(index.completions("/home/user/Do", 10), QStringList({"/home/user/Documents", "/home/user/Downloads"}));
+    QCOMPARE(index.completions("/home/user/Do", 1), QStringList({"/home/user/Documents"}));
+    QCOMPARE(index.completions("/home/user/Music", 10), QStringList({"/home/user/Music"}));
+    QCOMPARE(index.completions("/m", 10), QStringList({"/media/archive"}));
+    QVERIFY(index.completions("/home/other", 10).isEmpty());
+    QVERIFY(index.completions(QString(), 10).isEmpty());
+
+    index.clear();
+    QCOMPARE(index.count(), 0);
+    QVERIFY(index.completions("/", 10).isEmpty());
+}
+
+void DolphinLocationIndexTest::testWeights()
+{
+    DolphinLocationIndex index;
+    index.addLocation(QUrl::fromLocalFile("/data/a"), DolphinLocationIndex::VisitedLocation);
+    index.addLocation(QUrl::fromLocalFile("/data/b"), DolphinLocationIndex::VisitedLocation);
+    index.addLocation(QUrl::fromLocalFile("/data/b"), DolphinLocationIndex::VisitedLocation);
+    QCOMPARE(index.completions("/data/", 10), QStringList({"/data/b", "/data/a"}));
+
+    // Places get a minimum weight that is higher than a few visits.
+    index.addLocation(QUrl::fromLocalFile("/data/c"), DolphinLocationIndex::Place);
+    QCOMPARE(index.completions("/data/", 10), QStringList({"/data/c", "/data/b", "/data/a"}));
+
+    // Adding a place again does not increase its weight.
+    index.addLocation(QUrl::fromLocalFile("/data/c"), DolphinLocationIndex::Place);
+    for (int i = 0; i < 4; ++i) {
+        index.addLocation(QUrl::fromLocalFile("/data/a"), DolphinLocationIndex::VisitedLocation);
+    }
+    QCOMPARE(index.completions("/data/", 10), QStringList({"/data/a", "/data/c", "/data/b"}));
+    QCOMPARE(index.count(), 3);
+}
+
+void DolphinLocationIndexTest::testRemoteUrls()
+{
+    DolphinLocationIndex index;
+    index.addLocation(QUrl("sftp://server/home/user/"), DolphinLocationIndex::Bookmark);
+    QCOMPARE(index.completions("sftp://ser", 10), QStringList({"sftp://server/home/user"}));
+}
+
+void DolphinLocationIndexTest::testPersistence()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath("locationindex");
+
+    {
+        DolphinLocationIndex index(filePath);
+        index.addLocation(QUrl::fromLocalFile("/data/a"), DolphinLocationIndex::VisitedLocation);
+        index.addLocation(QUrl::fromLocalFile("/data/b"), DolphinLocationIndex::ClosedTab);
+        // The pending changes are saved when the index is destroyed.
+    }
+
+    DolphinLocationIndex index(filePath);
+    QCOMPARE(index.count(), 2);
+    QCOMPARE(index.completions("/data/", 10), QStringList({"/data/b", "/data/a"}));
+}
+
+QTEST_GUILESS_MAIN(DolphinLocationIndexTest)
+
+#include "dolphinlocationindextest.moc"
@@ -26,6 +26,7 @@
 
 #include <KActionCollection>
 #include <KConfig>
+#include <KConfigGroup>
 #include <KConfigGui>
 #include <KFileItem>
 
@@ -82,6 +83,7 @@ private Q_SLOTS:
     void testViewModeAfterDynamicView();
     void testActivationAndTabTitleAfterRenameOpeningFolder();
     void testActiveViewAfterTabSwitchWithSplitView();
+    void testLazyTabRestoration();
     void testFileItemActionsOutliveContextMenu();
     void cleanupTestCase();
 
@@ -1682,6 +1684,54 @@ void DolphinMainWindowTest::testActiveViewAfterTabSwitchWithSplitView()
     QVERIFY(!firstTabPage->primaryViewContainer()->isActive());
 }
 
+void DolphinMainWindowTest::testLazyTabRestoration()
+{
+    GeneralSettings::setLazyTabRestoration(true);
+    GeneralSettings::setWarmUpRestoredTabs(false);
+
+    const QUrl homeUrl = QUrl::fromLocalFile(QDir::homePath());
+    const QUrl tempUrl = QUrl::fromLocalFile(QDir::tempPath());
+    m_mainWindow->openDirectories({homeUrl}, false);
+    m_mainWindow->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_mainWindow.data()));
+
+    auto tabWidget = m_mainWindow->findChild<DolphinTabWidget *>("tabWidget");
+    QVERIFY(tabWidget);
+    tabWidget->openNewActivatedTab(homeUrl);
+    tabWidget->setCurrentIndex(0);
+    tabWidget->openNewTab(tempUrl, QUrl(), DolphinTabWidget::NewTabPosition::AfterCurrent);
+    tabWidget->setCurrentIndex(1);
+    QCOMPARE(tabWidget->count(), 3);
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup group = config.group(QStringLiteral("Tabs"));
+    tabWidget->saveProperties(group);
+    const QByteArray firstTabState = group.readEntry("Tab Data 0", QByteArray());
+
+    // Restoring creates the missing background tab without loading its directory.
+    tabWidget->closeTab(2);
+    QCOMPARE(tabWidget->count(), 2);
+
+    // Only the active tab loads its directory when the tabs are restored.
+    tabWidget->readProperties(group);
+    QCOMPARE(tabWidget->currentIndex(), 1);
+    DolphinTabPage *firstTabPage = tabWidget->tabPageAt(0);
+    QVERIFY(firstTabPage->isLoadingDeferred());
+    QVERIFY(!tabWidget->currentTabPage()->isLoadingDeferred());
+    QCOMPARE(firstTabPage->activeViewContainer()->url(), homeUrl);
+    QCOMPARE(tabWidget->count(), 3);
+    QVERIFY(tabWidget->tabPageAt(2)->activeViewContainer()->view()->isLoadingDeferred());
+    QCOMPARE(tabWidget->tabPageAt(2)->activeViewContainer()->url(), homeUrl);
+
+    // The state of a tab that has not been activated yet is kept.
+    QCOMPARE(firstTabPage->saveState(), firstTabState);
+
+    tabWidget->setCurrentIndex(0);
+    QVERIFY(!firstTabPage->isLoadingDeferred());
+    QVERIFY(!firstTabPage->activeViewContainer()->view()->isLoadingDeferred());
+    QCOMPARE(firstTabPage->activeViewContainer()->url(), homeUrl);
+}
+
 /**
  * A KFileItemAction plugin may spin the event loop while the context menu queries it, so the
  * KFileItemActions instance the menu was built from must survive unchanged until the menu is
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinservicemenucache.h"
+
+#include <KFileItemListProperties>
+
+#include <QFile>
+#include <QMenu>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QWidget>
+
+class DolphinServiceMenuCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testReuse();
+    void testPrepare();
+
+private:
+    KFileItem createItem(const QString &name, const QString &mimeType) const;
+
+    QTemporaryDir m_tempDir;
+    QWidget m_parentWidget;
+};
+
+void DolphinServiceMenuCacheTest::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+KFileItem DolphinServiceMenuCacheTest::createItem(const QString &name, const QString &mimeType) const
+{
+    QFile file(m_tempDir.filePath(name));
+    file.open(QIODevice::WriteOnly);
+    return KFileItem(QUrl::fromLocalFile(file.fileName()), mimeType);
+}
+
+void DolphinServiceMenuCacheTest::testReuse()
+{
+    DolphinServiceMenuCache cache(&m_parentWidget);
+    const KFileItem textFile1 = createItem(QStringLiteral("a.txt"), QStringLiteral("text/plain"));
+    const KFileItem textFile2 = createItem(QStringLiteral("b.txt"), QStringLiteral("text/plain"));
+    const KFileItem image = createItem(QStringLiteral("c.png"), QStringLiteral("image/png"));
+
+    QMenu menu;
+    cache.addActionsTo(&menu, KFileItemListProperties(KFileItemList{textFile1}));
+    QCOMPARE(cache.count(), 1);
+
+    // Items with the same MIME type and capabilities share the actions.
+    cache.addActionsTo(&menu, KFileItemListProperties(KFileItemList{textFile2}));
+    QCOMPARE(cache.count(), 1);
+
+    cache.addActionsTo(&menu, KFileItemListProperties(KFileItemList{image}));
+    QCOMPARE(cache.count(), 2);
+
+    // Service menus may require a number of items.
+    cache.addActionsTo(&menu, KFileItemListProperties(KFileItemList{textFile1, textFile2}));
+    QCOMPARE(cache.count(), 3);
+
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+}
+
+void DolphinServiceMenuCacheTest::testPrepare()
+{
+    DolphinServiceMenuCache cache(&m_parentWidget);
+    const KFileItem textFile1 = createItem(QStringLiteral("a.txt"), QStringLiteral("text/plain"));
+    const KFileItem textFile2 = createItem(QStringLiteral("b.txt"), QStringLiteral("text/plain"));
+    const KFileItem image = createItem(QStringLiteral("c.png"), QStringLiteral("image/png"));
+
+    // The actions are created in the background.
+    cache.prepare({KFileItemList{textFile1}, KFileItemList{textFile2}, KFileItemList{image}});
+    QCOMPARE(cache.count(), 0);
+    QTRY_COMPARE(cache.count(), 2);
+
+    // A new call discards the pending item lists.
+    cache.clear();
+    cache.prepare({KFileItemList{textFile1}, KFileItemList{image}});
+    cache.prepare({KFileItemList{image}});
+    QTRY_COMPARE(cache.count(), 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(cache.count(), 1);
+
+    QMenu menu;
+    cache.addActionsTo(&menu, KFileItemListProperties(KFileItemList{image}));
+    QCOMPARE(cache.count(), 1);
+}
+
+QTEST_MAIN(DolphinServiceMenuCacheTest)
+
+#include "dolphinservicemenucachetest.moc"
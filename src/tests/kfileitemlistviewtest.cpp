@@ -24,6 +24,7 @@ private Q_SLOTS:
     void init();
     void cleanup();
     void testGroupedItemChanges();
+    void testWidgetPool();
 
 private:
     KFileItemListView *m_listView;
@@ -111,6 +112,28 @@ void KFileItemListViewTest::testGroupedItemChanges()
     QCOMPARE(m_model->count(), 2);
 }
 
+/**
+ * If the layout has not been changed for a while, the view creates
+ * widgets in advance, so that no widgets must be created while scrolling.
+ */
+void KFileItemListViewTest::testWidgetPool()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+
+    m_listView->setGeometry(QRectF(0, 0, 400, 400));
+    m_testDir->createFiles({"a", "b", "c"});
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 3);
+
+    const int maximumVisibleItems = m_listView->maximumVisibleItems();
+    QVERIFY(maximumVisibleItems > 0);
+    const KItemListWidgetCreatorBase *creator = m_listView->widgetCreator();
+    QTRY_COMPARE(creator->recycleableWidgetCount(), maximumVisibleItems);
+    QVERIFY(creator->maximumRecycleableWidgets() >= maximumVisibleItems);
+}
+
 QTEST_MAIN(KFileItemListViewTest)
 
 #include "kfileitemlistviewtest.moc"
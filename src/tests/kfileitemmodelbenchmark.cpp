@@ -11,6 +11,7 @@
 
 #include <random>
 
+#include "benchmarkitemgenerator.h"
 #include "kitemviews/kfileitemmodel.h"
 #include "kitemviews/private/kfileitemmodelsortalgorithm.h"
 
@@ -48,9 +49,20 @@ private Q_SLOTS:
     void initTestCase();
     void insertAndRemoveManyItems_data();
     void insertAndRemoveManyItems();
+    void resortItems_data();
+    void resortItems();
+    void filterTyping_data();
+    void filterTyping();
+    void groups_data();
+    void groups();
+    void indexUnderChurn();
+    void insertExpandedTree_data();
+    void insertExpandedTree();
 
 private:
     static KFileItemList createFileItemList(const QStringList &fileNames, const QString &urlPrefix = QLatin1String("file:///"));
+    static void loadItems(KFileItemModel &model, const KFileItemList &items);
+    static QUrl benchmarkDirectory();
 };
 
 KFileItemModelBenchmark::KFileItemModelBenchmark()
@@ -60,6 +72,7 @@ KFileItemModelBenchmark::KFileItemModelBenchmark()
 void KFileItemModelBenchmark::initTestCase()
 {
     QStandardPaths::setTestModeEnabled(true);
+    BenchmarkItemGenerator::suppressMessages();
 }
 
 void KFileItemModelBenchmark::insertAndRemoveManyItems_data()
@@ -198,6 +211,194 @@ void KFileItemModelBenchmark::insertAndRemoveManyItems()
     }
 }
 
+void KFileItemModelBenchmark::resortItems_data()
+{
+    QTest::addColumn<QByteArray>("sortRole");
+    QTest::addColumn<bool>("naturalSorting");
+
+    const QList<QByteArray> sortRoles = {"text", "size", "modificationtime", "type"};
+    for (const QByteArray &sortRole : sortRoles) {
+        QTest::addRow("%s--natural", sortRole.constData()) << sortRole << true;
+        QTest::addRow("%s--plain", sortRole.constData()) << sortRole << false;
+    }
+}
+
+void KFileItemModelBenchmark::resortItems()
+{
+    QFETCH(QByteArray, sortRole);
+    QFETCH(bool, naturalSorting);
+
+    KFileItemModel model;
+    model.m_naturalSorting = naturalSorting;
+    model.setSortRole(sortRole, false);
+
+    BenchmarkItemGenerator generator;
+    loadItems(model, generator.naturalSortItems(benchmarkDirectory(), 20000));
+
+    QBENCHMARK {
+        model.setSortOrder(model.sortOrder() == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder);
+    }
+
+    QVERIFY(model.isConsistent());
+}
+
+void KFileItemModelBenchmark::filterTyping_data()
+{
+    QTest::addColumn<QStringList>("filters");
+
+    // Typing a filter character by character and removing it again
+    QStringList typedFilter;
+    const QString filter = QStringLiteral("IMG_01");
+    for (int i = 1; i <= filter.length(); ++i) {
+        typedFilter.append(filter.left(i));
+    }
+    for (int i = filter.length() - 1; i >= 0; --i) {
+        typedFilter.append(filter.left(i));
+    }
+    QTest::newRow("typing") << typedFilter;
+
+    // A filter that hides almost all items and a filter that hides none
+    QTest::newRow("toggle") << QStringList({QStringLiteral("IMG_0123"), QString()});
+}
+
+void KFileItemModelBenchmark::filterTyping()
+{
+    QFETCH(QStringList, filters);
+
+    KFileItemModel model;
+    BenchmarkItemGenerator generator;
+    loadItems(model, generator.naturalSortItems(benchmarkDirectory(), 20000));
+    const int itemCount = model.count();
+
+    QBENCHMARK {
+        for (const QString &filter : std::as_const(filters)) {
+            model.setNameFilter(filter);
+        }
+    }
+
+    QCOMPARE(model.count(), itemCount);
+    QVERIFY(model.isConsistent());
+}
+
+void KFileItemModelBenchmark::groups_data()
+{
+    QTest::addColumn<QByteArray>("groupRole");
+
+    const QList<QByteArray> groupRoles = {"text", "size", "modificationtime", "type"};
+    for (const QByteArray &groupRole : groupRoles) {
+        QTest::newRow(groupRole.constData()) << groupRole;
+    }
+}
+
+void KFileItemModelBenchmark::groups()
+{
+    QFETCH(QByteArray, groupRole);
+
+    KFileItemModel model;
+    model.setGroupedSorting(true);
+    model.setSortRole(groupRole, false);
+    model.setGroupRole(groupRole);
+
+    BenchmarkItemGenerator generator;
+    loadItems(model, generator.mixedMimeTypeItems(benchmarkDirectory(), 20000));
+
+    QBENCHMARK {
+        model.m_groups.clear();
+        QVERIFY(!model.groups().isEmpty());
+    }
+}
+
+void KFileItemModelBenchmark::indexUnderChurn()
+{
+    KFileItemModel model;
+    model.m_naturalSorting = false;
+
+    BenchmarkItemGenerator generator;
+    loadItems(model, generator.mixedMimeTypeItems(benchmarkDirectory(), 20000));
+
+    // Items are added and removed while the lookups by URL happen, which
+    // invalidates the URL index of the model each time.
+    const KFileItemList churnItems = generator.naturalSortItems(benchmarkDirectory(), 100);
+    KFileItemList lookedUpItems;
+    for (int i = 0; i < model.count(); i += 100) {
+        lookedUpItems.append(model.fileItem(i));
+    }
+
+    QBENCHMARK {
+        model.slotItemsAdded(model.directory(), churnItems);
+        model.slotCompleted();
+        for (const KFileItem &item : std::as_const(lookedUpItems)) {
+            QVERIFY(model.index(item.url()) >= 0);
+        }
+
+        model.slotItemsDeleted(churnItems);
+        for (const KFileItem &item : std::as_const(lookedUpItems)) {
+            QVERIFY(model.index(item.url()) >= 0);
+        }
+    }
+
+    QVERIFY(model.isConsistent());
+}
+
+void KFileItemModelBenchmark::insertExpandedTree_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("foldersPerFolder");
+    QTest::addColumn<int>("filesPerFolder");
+
+    QTest::newRow("deep") << 8 << 2 << 20;
+    QTest::newRow("wide") << 3 << 20 << 20;
+}
+
+void KFileItemModelBenchmark::insertExpandedTree()
+{
+    QFETCH(int, depth);
+    QFETCH(int, foldersPerFolder);
+    QFETCH(int, filesPerFolder);
+
+    KFileItemModel model;
+    model.setRoles({"text", "isExpanded", "isExpandable", "expandedParentsCount"});
+
+    BenchmarkItemGenerator generator;
+    const auto tree = generator.expandedTree(benchmarkDirectory(), depth, foldersPerFolder, filesPerFolder);
+    int itemCount = 0;
+    for (const auto &folder : tree) {
+        itemCount += folder.second.count();
+    }
+
+    SmallHash expanded;
+    expanded.insert("isExpanded", true);
+
+    QBENCHMARK {
+        model.slotClear();
+        for (const auto &folder : tree) {
+            if (folder.first == benchmarkDirectory()) {
+                model.slotItemsAdded(model.directory(), folder.second);
+            } else {
+                // Mark the folder as expanded without listing it
+                model.setData(model.index(folder.first), expanded);
+                model.slotItemsAdded(folder.first, folder.second);
+            }
+            model.slotCompleted();
+        }
+        QCOMPARE(model.count(), itemCount);
+    }
+
+    QVERIFY(model.isConsistent());
+}
+
+void KFileItemModelBenchmark::loadItems(KFileItemModel &model, const KFileItemList &items)
+{
+    model.slotItemsAdded(model.directory(), items);
+    model.slotCompleted();
+    QCOMPARE(model.count(), items.count());
+}
+
+QUrl KFileItemModelBenchmark::benchmarkDirectory()
+{
+    return QUrl::fromLocalFile(QStringLiteral("/benchmark"));
+}
+
 KFileItemList KFileItemModelBenchmark::createFileItemList(const QStringList &fileNames, const QString &prefix)
 {
     // Suppress 'file does not exist anymore' messages from KFileItemPrivate::init().
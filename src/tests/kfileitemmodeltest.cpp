@@ -5,7 +5,9 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QLocale>
 #include <QMimeData>
+#include <QMimeDatabase>
 #include <QRandomGenerator>
 #include <QSignalSpy>
 #include <QStandardPaths>
@@ -56,9 +58,11 @@ private Q_SLOTS:
     void testRemoveItems();
     void testDirLoadingCompleted();
     void testSetData();
+    void testSetItemsData();
     void testSetDataWithModifiedSortRole_data();
     void testSetDataWithModifiedSortRole();
     void testChangeSortRole();
+    void testSortByTypeWithUnknownMimeTypes();
     void testResortAfterChangingName();
     void testModelConsistencyWhenInsertingItems();
     void testItemRangeConsistencyWhenInsertingItems();
@@ -84,6 +88,8 @@ private Q_SLOTS:
     void testGeneralParentChildRelationships();
     void testNameRoleGroups();
     void testNameRoleGroupsWithExpandedItems();
+    void testTimeRoleGroups();
+    void testGroupsAfterInsertingAndRemovingItems();
     void testGroupRoleFallsBackToSortRole();
     void testGroupRoleIndependentFromSortRole();
     void testGroupRoleNotResetBySortRoleChange();
@@ -95,6 +101,11 @@ private Q_SLOTS:
     void testCollapseFolderWhileLoading();
     void testCreateMimeData();
     void testDeleteFileMoreThanOnce();
+    void testDeleteManyItems();
+    void testInsertItemsWhileLoading();
+    void testRefreshUnchangedItems();
+    void testExpandSubtree();
+    void testSearchResultsInArrivalOrder();
     void testInsertAfterExpand();
     void testCurrentDirRemoved();
     void testSizeSortingAfterRefresh();
@@ -274,6 +285,41 @@ void KFileItemModelTest::testSetData()
     QVERIFY(m_model->isConsistent());
 }
 
+void KFileItemModelTest::testSetItemsData()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+    QSignalSpy itemsChangedSpy(m_model, &KFileItemModel::itemsChanged);
+    QVERIFY(itemsChangedSpy.isValid());
+
+    m_testDir->createFiles({"a.txt", "b.txt", "c.txt", "d.txt"});
+
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 4);
+
+    QHash<int, SmallHash> itemsValues;
+    itemsValues[0].insert("customRole", "Test0");
+    itemsValues[1].insert("customRole", "Test1");
+    itemsValues[3].insert("customRole", "Test3");
+
+    // The changes of all items are notified by one signal.
+    QVERIFY(m_model->setItemsData(itemsValues));
+    QCOMPARE(itemsChangedSpy.count(), 1);
+    const KItemRangeList itemRanges = itemsChangedSpy.takeFirst().at(0).value<KItemRangeList>();
+    QCOMPARE(itemRanges, KItemRangeList() << KItemRange(0, 2) << KItemRange(3, 1));
+
+    QCOMPARE(m_model->data(0).value("customRole").toString(), QStringLiteral("Test0"));
+    QCOMPARE(m_model->data(1).value("customRole").toString(), QStringLiteral("Test1"));
+    QVERIFY(!m_model->data(2).contains("customRole"));
+    QCOMPARE(m_model->data(3).value("customRole").toString(), QStringLiteral("Test3"));
+
+    // Setting unchanged values does not emit itemsChanged().
+    QVERIFY(!m_model->setItemsData(itemsValues));
+    QCOMPARE(itemsChangedSpy.count(), 0);
+    QVERIFY(m_model->isConsistent());
+}
+
 void KFileItemModelTest::testSetDataWithModifiedSortRole_data()
 {
     QTest::addColumn<int>("changedIndex");
@@ -406,6 +452,38 @@ void KFileItemModelTest::testChangeSortRole()
     QVERIFY(ok1 || ok2);
 }
 
+void KFileItemModelTest::testSortByTypeWithUnknownMimeTypes()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+
+    // The MIME-types are not determined by the model: the items must
+    // nevertheless be sorted by the type guessed from their extension.
+    m_model->setSortRole("type");
+    m_testDir->createFiles({"a.txt", "b.jpg", "c.txt"});
+
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+
+    // The actual order of the files might depend on the translation of the
+    // result of KFileItem::mimeComment() in the user's language.
+    const QStringList version1{"b.jpg", "a.txt", "c.txt"};
+    const QStringList version2{"a.txt", "c.txt", "b.jpg"};
+
+    const bool ok1 = (itemsInModel() == version1);
+    const bool ok2 = (itemsInModel() == version2);
+
+    QVERIFY(ok1 || ok2);
+    QVERIFY(m_model->isConsistent());
+
+    // The type has been guessed without determining the MIME-types.
+    const QMimeDatabase db;
+    for (int i = 0; i < m_model->count(); ++i) {
+        const KFileItem item = m_model->fileItem(i);
+        QVERIFY(!item.isMimeTypeKnown());
+        QCOMPARE(m_model->data(i).value("type").toString(), db.mimeTypeForFile(item.text(), QMimeDatabase::MatchExtension).comment());
+    }
+}
+
 void KFileItemModelTest::testResortAfterChangingName()
 {
     QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
@@ -1791,8 +1869,8 @@ void KFileItemModelTest::testRefreshExpandedFolderWithFilter()
                            << "someFolder");
 
     // slotRefreshItems() should preserve "isExpanded" and "expandedParentsCount" values explicitly in this case
-    QCOMPARE(m_model->m_itemData.at(2)->values.value("isExpanded").toBool(), true);
-    QCOMPARE(m_model->m_itemData.at(2)->values.value("expandedParentsCount"), 2);
+    QCOMPARE(m_model->m_itemData.at(2)->values.value(KFileItemModel::IsExpandedRole).toBool(), true);
+    QCOMPARE(m_model->m_itemData.at(2)->values.value(KFileItemModel::ExpandedParentsCountRole), 2);
 }
 
 /**
@@ -2657,6 +2735,268 @@ void KFileItemModelTest::testDeleteFileMoreThanOnce()
                            << "d.txt");
 }
 
+void KFileItemModelTest::testDeleteManyItems()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+    QSignalSpy itemsRemovedSpy(m_model, &KFileItemModel::itemsRemoved);
+    QVERIFY(itemsRemovedSpy.isValid());
+    QSignalSpy fileItemsChangedSpy(m_model, &KFileItemModel::fileItemsChanged);
+    QVERIFY(fileItemsChangedSpy.isValid());
+
+    QSet<QByteArray> modelRoles = m_model->roles();
+    modelRoles << "isExpanded"
+               << "isExpandable"
+               << "expandedParentsCount";
+    m_model->setRoles(modelRoles);
+
+    QStringList files = {"a/1", "a/2", "a/3"};
+    for (int i = 0; i < 150; ++i) {
+        files << QStringLiteral("f%1.txt").arg(i, 3, 10, QLatin1Char('0'));
+    }
+    m_testDir->createFiles(files);
+
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 151);
+
+    m_model->setExpanded(0, true);
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 154);
+
+    // Delete enough items to determine their indexes by one pass over all items.
+    // The list contains the expanded folder "a/" and one of its children.
+    KFileItemList deletedItems;
+    deletedItems << m_model->fileItem(0) << m_model->fileItem(2);
+    for (int index = 4; index < 124; ++index) {
+        deletedItems << m_model->fileItem(index);
+    }
+    itemsRemovedSpy.clear();
+    m_model->slotItemsDeleted(deletedItems);
+
+    QVERIFY(m_model->isConsistent());
+    QCOMPARE(m_model->count(), 30);
+    QCOMPARE(m_model->fileItem(0).name(), QStringLiteral("f120.txt"));
+
+    QCOMPARE(itemsRemovedSpy.count(), 1);
+    const KItemRangeList itemRangeList = itemsRemovedSpy.takeFirst().at(0).value<KItemRangeList>();
+    QCOMPARE(itemRangeList, KItemRangeList() << KItemRange(0, 124));
+
+    QCOMPARE(fileItemsChangedSpy.count(), 1);
+    const QList<QUrl> dirsChanged = fileItemsChangedSpy.takeFirst().at(0).value<KFileItemList>().urlList();
+    QCOMPARE(QSet<QUrl>(dirsChanged.begin(), dirsChanged.end()),
+             QSet<QUrl>({m_testDir->url().adjusted(QUrl::StripTrailingSlash), QUrl::fromLocalFile(m_testDir->path() + "/a")}));
+}
+
+void KFileItemModelTest::testInsertItemsWhileLoading()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+    QSignalSpy itemsMovedSpy(m_model, &KFileItemModel::itemsMoved);
+    QVERIFY(itemsMovedSpy.isValid());
+    QTimer *updateTimer = m_model->m_maximumUpdateIntervalTimer;
+
+    const QUrl url = m_testDir->url();
+    int itemCount = 0;
+    auto createItems = [&url, &itemCount](int count, const QString &prefix = QStringLiteral("file")) {
+        KFileItemList items;
+        for (int i = 0; i < count; ++i) {
+            items << KFileItem(subDir(url, prefix + QString::number(itemCount++)), QString(), KFileItem::Unknown);
+        }
+        return items;
+    };
+
+    // The items of a directory that is completed within the maximum
+    // update interval are inserted at once.
+    m_model->slotItemsAdded(url, createItems(100));
+    QCOMPARE(updateTimer->interval(), 2000);
+    QVERIFY(updateTimer->isActive());
+    QVERIFY(!itemsInsertedSpy.wait(300));
+    QCOMPARE(m_model->count(), 0);
+    m_model->slotCompleted();
+    QCOMPARE(m_model->count(), 100);
+    QCOMPARE(itemsInsertedSpy.count(), 1);
+    QCOMPARE(updateTimer->interval(), 2000);
+
+    m_model->slotClear();
+    itemsInsertedSpy.clear();
+
+    // The first items of a large directory are shown as soon as they fill the view
+    m_model->setMaximumVisibleItems(50);
+    m_model->slotItemsAdded(url, createItems(30));
+    QCOMPARE(m_model->count(), 0);
+    m_model->slotItemsAdded(url, createItems(20));
+    QCOMPARE(m_model->count(), 50);
+    QCOMPARE(itemsInsertedSpy.count(), 1);
+    QVERIFY(!updateTimer->isActive());
+    itemsInsertedSpy.clear();
+
+    // The remaining items are inserted with a growing interval
+    m_model->slotItemsAdded(url, createItems(10));
+    QCOMPARE(updateTimer->interval(), 200);
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 60);
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(50, 10));
+
+    // Items that belong before the visible items are inserted behind them
+    m_model->setVisibleIndexRange(0, 55);
+    m_model->slotItemsAdded(url, createItems(10, QStringLiteral("a")));
+    QCOMPARE(updateTimer->interval(), 400);
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 70);
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(55, 10));
+    QCOMPARE(m_model->fileItem(0).text(), QStringLiteral("file0"));
+    QCOMPARE(m_model->fileItem(55).text(), QStringLiteral("a60"));
+    QVERIFY(itemsMovedSpy.isEmpty());
+
+    // The items get sorted when the loading has been completed
+    m_model->slotItemsAdded(url, createItems(10));
+    QCOMPARE(updateTimer->interval(), 800);
+    m_model->slotCompleted();
+    QCOMPARE(m_model->count(), 80);
+    QCOMPARE(updateTimer->interval(), 2000);
+    QCOMPARE(itemsMovedSpy.count(), 1);
+    QCOMPARE(m_model->fileItem(0).text(), QStringLiteral("a60"));
+    QVERIFY(m_model->isConsistent());
+}
+
+/**
+ * Verifies that refreshing items whose shown properties did not change
+ * does not emit itemsChanged, but still emits fileItemsChanged.
+ */
+void KFileItemModelTest::testRefreshUnchangedItems()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+    QSignalSpy itemsChangedSpy(m_model, &KFileItemModel::itemsChanged);
+    QVERIFY(itemsChangedSpy.isValid());
+    QSignalSpy fileItemsChangedSpy(m_model, &KFileItemModel::fileItemsChanged);
+    QVERIFY(fileItemsChangedSpy.isValid());
+
+    m_testDir->createFiles({"a.txt", "b.txt", "c.txt"});
+
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(m_model->count(), 3);
+
+    const KFileItem itemA = m_model->fileItem(0);
+    const KFileItem itemB = m_model->fileItem(1);
+    itemsChangedSpy.clear();
+    m_model->slotRefreshItems({qMakePair(itemA, itemA), qMakePair(itemB, itemB)});
+
+    QVERIFY(itemsChangedSpy.isEmpty());
+    QCOMPARE(fileItemsChangedSpy.count(), 1);
+    QCOMPARE(fileItemsChangedSpy.takeFirst().at(0).value<KFileItemList>().count(), 2);
+
+    // If a shown property has been changed, only the changed item is updated.
+    KFileItem renamedItemB = itemB;
+    renamedItemB.setName(QStringLiteral("d.txt"));
+    m_model->slotRefreshItems({qMakePair(itemA, itemA), qMakePair(itemB, renamedItemB)});
+
+    QCOMPARE(itemsChangedSpy.count(), 1);
+    QCOMPARE(itemsChangedSpy.first().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(1, 1));
+    QVERIFY(itemsChangedSpy.first().at(1).value<QSet<QByteArray>>().contains("text"));
+    QCOMPARE(fileItemsChangedSpy.count(), 1);
+    QCOMPARE(fileItemsChangedSpy.takeFirst().at(0).value<KFileItemList>().count(), 2);
+}
+
+void KFileItemModelTest::testExpandSubtree()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+    QSignalSpy progressSpy(m_model, &KFileItemModel::subtreeExpansionProgress);
+    QVERIFY(progressSpy.isValid());
+
+    QSet<QByteArray> modelRoles = m_model->roles();
+    modelRoles << "isExpanded"
+               << "isExpandable"
+               << "expandedParentsCount";
+    m_model->setRoles(modelRoles);
+
+    m_testDir->createFiles({"a/b/c/1", "a/b/2", "a/e/3", "a/4", "d/5"});
+
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(itemsInModel(), QStringList({"a", "d"}));
+
+    QVERIFY(!m_model->expandSubtree(0, 0));
+
+    // Expand "a/" and its sub-folders "a/b/" and "a/e/", but not "a/b/c/"
+    QVERIFY(m_model->expandSubtree(0, 2));
+    QTRY_VERIFY(!progressSpy.isEmpty() && progressSpy.last().at(0).toInt() == 100);
+    QCOMPARE(itemsInModel(), QStringList({"a", "b", "c", "2", "e", "3", "4", "d"}));
+    QVERIFY(m_model->isExpanded(0));
+    QVERIFY(m_model->isExpanded(1));
+    QVERIFY(!m_model->isExpanded(2));
+    QVERIFY(m_model->isExpanded(4));
+    QVERIFY(!m_model->isExpanded(7));
+    QVERIFY(m_model->isConsistent());
+
+    // Expanding the subtree again only lists the folders that are not expanded yet
+    progressSpy.clear();
+    QVERIFY(m_model->expandSubtree(0, 3));
+    QTRY_VERIFY(!progressSpy.isEmpty() && progressSpy.last().at(0).toInt() == 100);
+    QCOMPARE(itemsInModel(), QStringList({"a", "b", "c", "1", "2", "e", "3", "4", "d"}));
+    QVERIFY(m_model->isExpanded(2));
+    QVERIFY(m_model->isConsistent());
+}
+
+void KFileItemModelTest::testSearchResultsInArrivalOrder()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+    QVERIFY(itemsInsertedSpy.isValid());
+
+    const QUrl url = m_testDir->url();
+    auto createItems = [&url](const QStringList &names) {
+        KFileItemList items;
+        for (const QString &name : names) {
+            items << KFileItem(subDir(url, name), QString(), KFileItem::Unknown);
+        }
+        return items;
+    };
+
+    // Simulate a filename search that is still running
+    m_model->setSearchTerm(QStringLiteral("report"));
+    m_model->m_sortingDeferred = true;
+
+    // The first items are ordered by their relevance
+    m_model->slotItemsAdded(url, createItems({"old_reports.txt", "xreport", "report"}));
+    m_model->dispatchPendingItemsToInsert();
+    QCOMPARE(itemsInModel(), QStringList({"report", "old_reports.txt", "xreport"}));
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(0, 3));
+
+    m_model->slotItemsAdded(url, createItems({"c-report.txt", "b.txt", "report-2026.txt"}));
+    m_model->dispatchPendingItemsToInsert();
+    QCOMPARE(itemsInModel(), QStringList({"report", "report-2026.txt", "old_reports.txt", "c-report.txt", "xreport", "b.txt"}));
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(1, 1) << KItemRange(2, 1) << KItemRange(3, 1));
+
+    // Less relevant items are appended in the order of their arrival
+    QStringList fileNames;
+    for (int i = 49; i >= 0; --i) {
+        fileNames << QStringLiteral("file%1.txt").arg(i, 2, 10, QLatin1Char('0'));
+    }
+    m_model->slotItemsAdded(url, createItems(fileNames));
+    m_model->dispatchPendingItemsToInsert();
+    QCOMPARE(itemsInModel().mid(6), fileNames);
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(6, 50));
+
+    // Only the first items are reordered when more relevant items arrive
+    m_model->slotItemsAdded(url, createItems({"a.txt", "report.pdf"}));
+    m_model->dispatchPendingItemsToInsert();
+    QCOMPARE(m_model->count(), 58);
+    QCOMPARE(m_model->fileItem(2).text(), QStringLiteral("report.pdf"));
+    QCOMPARE(m_model->fileItem(57).text(), QStringLiteral("a.txt"));
+    QCOMPARE(itemsInsertedSpy.takeFirst().at(0).value<KItemRangeList>(), KItemRangeList() << KItemRange(2, 1) << KItemRange(56, 1));
+    QVERIFY(m_model->isSortingDeferred());
+    QVERIFY(m_model->groups().isEmpty());
+
+    // The items are sorted when the search has been completed
+    m_model->slotCompleted();
+    QVERIFY(!m_model->isSortingDeferred());
+    QCOMPARE(m_model->fileItem(0).text(), QStringLiteral("a.txt"));
+    QVERIFY(m_model->isConsistent());
+}
+
 void KFileItemModelTest::testInsertAfterExpand()
 {
     m_model->m_dirLister->setAutoUpdate(true);
@@ -2902,6 +3242,88 @@ QUrl KFileItemModelTest::subDir(QUrl parent, const QString &relativePath)
     return parent.resolved(QUrl(relativePath));
 }
 
+void KFileItemModelTest::testTimeRoleGroups()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate oldMonth = now.date().addYears(-3);
+    const QDateTime oldTime1(QDate(oldMonth.year(), oldMonth.month(), 10), QTime(12, 0));
+    const QDateTime oldTime2(QDate(oldMonth.year(), oldMonth.month(), 20), QTime(12, 0));
+
+    m_testDir->createFile("a.txt", "test", oldTime1);
+    m_testDir->createFile("b.txt", "test", oldTime2);
+    m_testDir->createFile("c.txt", "test", now);
+
+    m_model->setSortRole("modificationtime");
+    m_model->setGroupedSorting(true);
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+    QCOMPARE(itemsInModel(), QStringList() << "a.txt" << "b.txt" << "c.txt");
+
+    // Files of the same month share a group, and files of the current day are in "Today".
+    const QList<QPair<int, QVariant>> groups = m_model->groups();
+    if (QDate::currentDate() != now.date()) {
+        // The model has read the current date after midnight, so "now" is not "Today" anymore.
+        QSKIP("The date has changed while running the test");
+    }
+
+    QList<QPair<int, QVariant>> expectedGroups;
+    expectedGroups << QPair<int, QVariant>(0, QLocale().toString(oldTime1, QStringLiteral("MMMM, yyyy")));
+    expectedGroups << QPair<int, QVariant>(2, QStringLiteral("Today"));
+    QCOMPARE(groups, expectedGroups);
+}
+
+void KFileItemModelTest::testGroupsAfterInsertingAndRemovingItems()
+{
+    QSignalSpy itemsInsertedSpy(m_model, &KFileItemModel::itemsInserted);
+
+    m_testDir->createFiles({"b.txt", "c.txt", "e.txt"});
+
+    m_model->setGroupedSorting(true);
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(itemsInsertedSpy.wait());
+
+    QList<QPair<int, QVariant>> expectedGroups;
+    expectedGroups << QPair<int, QVariant>(0, QLatin1String("B"));
+    expectedGroups << QPair<int, QVariant>(1, QLatin1String("C"));
+    expectedGroups << QPair<int, QVariant>(2, QLatin1String("E"));
+    QCOMPARE(m_model->groups(), expectedGroups);
+
+    // Insert items in front of, into and behind the existing groups. The cached
+    // groups are updated incrementally and must match regrouping all items.
+    KFileItemList newItems;
+    for (const QString &name : {"a.txt", "c2.txt", "d.txt", "f.txt"}) {
+        newItems << KFileItem(QUrl::fromLocalFile(m_testDir->path() + QLatin1Char('/') + name));
+    }
+    m_model->slotItemsAdded(m_testDir->url(), newItems);
+    m_model->slotCompleted();
+    QCOMPARE(itemsInModel(), QStringList() << "a.txt" << "b.txt" << "c.txt" << "c2.txt" << "d.txt" << "e.txt" << "f.txt");
+
+    expectedGroups.clear();
+    expectedGroups << QPair<int, QVariant>(0, QLatin1String("A"));
+    expectedGroups << QPair<int, QVariant>(1, QLatin1String("B"));
+    expectedGroups << QPair<int, QVariant>(2, QLatin1String("C"));
+    expectedGroups << QPair<int, QVariant>(4, QLatin1String("D"));
+    expectedGroups << QPair<int, QVariant>(5, QLatin1String("E"));
+    expectedGroups << QPair<int, QVariant>(6, QLatin1String("F"));
+    QCOMPARE(m_model->groups(), expectedGroups);
+    QCOMPARE(m_model->groups(), m_model->computeGroups(0, m_model->count() - 1));
+
+    // Remove the first item of a group that has more items, and a whole group.
+    m_model->slotItemsDeleted(KFileItemList() << m_model->fileItem(2) << m_model->fileItem(4));
+    QCOMPARE(itemsInModel(), QStringList() << "a.txt" << "b.txt" << "c2.txt" << "e.txt" << "f.txt");
+
+    expectedGroups.clear();
+    expectedGroups << QPair<int, QVariant>(0, QLatin1String("A"));
+    expectedGroups << QPair<int, QVariant>(1, QLatin1String("B"));
+    expectedGroups << QPair<int, QVariant>(2, QLatin1String("C"));
+    expectedGroups << QPair<int, QVariant>(3, QLatin1String("E"));
+    expectedGroups << QPair<int, QVariant>(4, QLatin1String("F"));
+    QCOMPARE(m_model->groups(), expectedGroups);
+    QCOMPARE(m_model->groups(), m_model->computeGroups(0, m_model->count() - 1));
+}
+
 void KFileItemModelTest::testGroupRoleFallsBackToSortRole()
 {
     QCOMPARE(m_model->rawGroupRole(), QByteArray());
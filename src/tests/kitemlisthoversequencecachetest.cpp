@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemviews/private/kitemlisthoversequencecache.h"
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+
+class KItemListHoverSequenceCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void testFrames();
+    void testModificationTime();
+    void testFrameSize();
+    void testMaximumSize();
+
+private:
+    static QPixmap createFrame(QRgb color);
+    static QPixmap createNoiseFrame();
+
+    int m_defaultMaximumSize = 0;
+};
+
+void KItemListHoverSequenceCacheTest::initTestCase()
+{
+    m_defaultMaximumSize = KItemListHoverSequenceCache::instance()->maximumSize();
+}
+
+void KItemListHoverSequenceCacheTest::init()
+{
+    KItemListHoverSequenceCache::instance()->clear();
+    KItemListHoverSequenceCache::instance()->setMaximumSize(m_defaultMaximumSize);
+}
+
+void KItemListHoverSequenceCacheTest::cleanupTestCase()
+{
+    KItemListHoverSequenceCache::instance()->setMaximumSize(m_defaultMaximumSize);
+}
+
+QPixmap KItemListHoverSequenceCacheTest::createFrame(QRgb color)
+{
+    QImage image(64, 64, QImage::Format_RGB32);
+    image.fill(color);
+    return QPixmap::fromImage(image);
+}
+
+QPixmap KItemListHoverSequenceCacheTest::createNoiseFrame()
+{
+    QImage image(128, 128, QImage::Format_RGB32);
+    QRandomGenerator generator(42);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, generator.generate());
+        }
+    }
+    return QPixmap::fromImage(image);
+}
+
+void KItemListHoverSequenceCacheTest::testFrames()
+{
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QUrl url = QUrl::fromLocalFile(QStringLiteral("/videos/a.mp4"));
+    const QDateTime modificationTime = QDateTime::currentDateTime();
+    const QSize frameSize(64, 64);
+
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime), 0);
+    QVERIFY(cache->frame(url, frameSize, 1).isNull());
+
+    cache->appendFrame(url, frameSize, modificationTime, createFrame(qRgb(255, 0, 0)));
+    cache->appendFrame(url, frameSize, modificationTime, createFrame(qRgb(0, 0, 255)));
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime), 2);
+
+    // The sequence index 0 belongs to the regular preview.
+    QVERIFY(cache->frame(url, frameSize, 0).isNull());
+
+    const QImage frame1 = cache->frame(url, frameSize, 1).toImage();
+    QCOMPARE(frame1.size(), QSize(64, 64));
+    QVERIFY(qRed(frame1.pixel(32, 32)) > 200);
+    QVERIFY(qBlue(frame1.pixel(32, 32)) < 50);
+
+    // The last loaded frame is used if a frame has not been loaded yet.
+    const QImage frame3 = cache->frame(url, frameSize, 3).toImage();
+    QVERIFY(qBlue(frame3.pixel(32, 32)) > 200);
+
+    cache->remove(url);
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime), 0);
+}
+
+void KItemListHoverSequenceCacheTest::testModificationTime()
+{
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QUrl url = QUrl::fromLocalFile(QStringLiteral("/videos/a.mp4"));
+    const QDateTime modificationTime = QDateTime::currentDateTime();
+    const QSize frameSize(64, 64);
+
+    cache->appendFrame(url, frameSize, modificationTime, createFrame(qRgb(255, 0, 0)));
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime), 1);
+
+    // Frames of a changed file are not used anymore.
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime.addSecs(1)), 0);
+    QVERIFY(cache->frame(url, frameSize, 1).isNull());
+
+    cache->appendFrame(url, frameSize, modificationTime, createFrame(qRgb(255, 0, 0)));
+    cache->appendFrame(url, frameSize, modificationTime.addSecs(1), createFrame(qRgb(0, 0, 255)));
+    QCOMPARE(cache->frameCount(url, frameSize, modificationTime.addSecs(1)), 1);
+}
+
+void KItemListHoverSequenceCacheTest::testFrameSize()
+{
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QUrl url = QUrl::fromLocalFile(QStringLiteral("/videos/a.mp4"));
+    const QDateTime modificationTime = QDateTime::currentDateTime();
+    const QSize smallFrameSize(64, 64);
+    const QSize largeFrameSize(128, 128);
+
+    // Frames of another size, e.g. of a view with another zoom level, are not used.
+    cache->appendFrame(url, smallFrameSize, modificationTime, createFrame(qRgb(255, 0, 0)));
+    QCOMPARE(cache->frameCount(url, smallFrameSize, modificationTime), 1);
+    QCOMPARE(cache->frameCount(url, largeFrameSize, modificationTime), 0);
+    QVERIFY(cache->frame(url, largeFrameSize, 1).isNull());
+
+    cache->appendFrame(url, largeFrameSize, modificationTime, createNoiseFrame());
+    QCOMPARE(cache->frameCount(url, largeFrameSize, modificationTime), 1);
+    QCOMPARE(cache->frame(url, largeFrameSize, 1).size(), largeFrameSize);
+    QCOMPARE(cache->frame(url, smallFrameSize, 1).size(), smallFrameSize);
+
+    // Removing an item removes the frames of all sizes.
+    cache->remove(url);
+    QCOMPARE(cache->frameCount(url, smallFrameSize, modificationTime), 0);
+    QCOMPARE(cache->frameCount(url, largeFrameSize, modificationTime), 0);
+}
+
+void KItemListHoverSequenceCacheTest::testMaximumSize()
+{
+    KItemListHoverSequenceCache *cache = KItemListHoverSequenceCache::instance();
+    const QUrl url1 = QUrl::fromLocalFile(QStringLiteral("/videos/1.mp4"));
+    const QUrl url2 = QUrl::fromLocalFile(QStringLiteral("/videos/2.mp4"));
+    const QUrl url3 = QUrl::fromLocalFile(QStringLiteral("/videos/3.mp4"));
+    const QDateTime modificationTime = QDateTime::currentDateTime();
+    const QSize frameSize(64, 64);
+    const QPixmap frame = createNoiseFrame();
+
+    cache->appendFrame(url1, frameSize, modificationTime, frame);
+    const int itemSize = cache->size();
+    QVERIFY(itemSize > 1);
+
+    cache->setMaximumSize(2 * itemSize + itemSize / 2);
+    cache->appendFrame(url2, frameSize, modificationTime, frame);
+    QCOMPARE(cache->frameCount(url1, frameSize, modificationTime), 1);
+
+    // The frames of the least recently used item are removed.
+    cache->appendFrame(url3, frameSize, modificationTime, frame);
+    QCOMPARE(cache->frameCount(url2, frameSize, modificationTime), 0);
+    QCOMPARE(cache->frameCount(url1, frameSize, modificationTime), 1);
+    QCOMPARE(cache->frameCount(url3, frameSize, modificationTime), 1);
+    QVERIFY(cache->size() <= cache->maximumSize());
+}
+
+QTEST_MAIN(KItemListHoverSequenceCacheTest)
+
+#include "kitemlisthoversequencecachetest.moc"
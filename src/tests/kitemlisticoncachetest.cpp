@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemviews/private/kitemlisticoncache.h"
+
+#include <QImage>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+class KItemListIconCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void testPixmap();
+    void testMaximumSize();
+
+private:
+    QString createIcon(const QString &fileName);
+
+    QTemporaryDir m_dir;
+    int m_defaultMaximumSize = 0;
+};
+
+void KItemListIconCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+    m_defaultMaximumSize = KItemListIconCache::instance()->maximumSize();
+}
+
+void KItemListIconCacheTest::init()
+{
+    KItemListIconCache::instance()->clear();
+    KItemListIconCache::instance()->setMaximumSize(m_defaultMaximumSize);
+}
+
+void KItemListIconCacheTest::cleanupTestCase()
+{
+    KItemListIconCache::instance()->setMaximumSize(m_defaultMaximumSize);
+}
+
+QString KItemListIconCacheTest::createIcon(const QString &fileName)
+{
+    QImage image(64, 64, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    const QString filePath = m_dir.filePath(fileName);
+    image.save(filePath);
+    return filePath;
+}
+
+void KItemListIconCacheTest::testPixmap()
+{
+    KItemListIconCache *cache = KItemListIconCache::instance();
+    const QString icon = createIcon(QStringLiteral("icon.png"));
+
+    const QPixmap pixmap = cache->pixmap(icon, 32, 1.0);
+    QCOMPARE(pixmap.size(), QSize(32, 32));
+    QCOMPARE(pixmap.devicePixelRatio(), 1.0);
+    QCOMPARE(cache->count(), 1);
+
+    // A second request is answered from the cache.
+    QCOMPARE(cache->pixmap(icon, 32, 1.0).cacheKey(), pixmap.cacheKey());
+    QCOMPARE(cache->count(), 1);
+
+    const QPixmap highDpiPixmap = cache->pixmap(icon, 32, 2.0);
+    QCOMPARE(highDpiPixmap.size(), QSize(64, 64));
+    QCOMPARE(highDpiPixmap.devicePixelRatio(), 2.0);
+    QCOMPARE(cache->count(), 2);
+
+    cache->prewarm({icon}, 16, 1.0);
+    QCOMPARE(cache->count(), 3);
+}
+
+void KItemListIconCacheTest::testMaximumSize()
+{
+    KItemListIconCache *cache = KItemListIconCache::instance();
+    const QString icon1 = createIcon(QStringLiteral("icon1.png"));
+    const QString icon2 = createIcon(QStringLiteral("icon2.png"));
+    const QString icon3 = createIcon(QStringLiteral("icon3.png"));
+
+    // Each 32x32 pixmap requires 4 kilobytes.
+    cache->setMaximumSize(10);
+    cache->pixmap(icon1, 32, 1.0);
+    cache->pixmap(icon2, 32, 1.0);
+    QCOMPARE(cache->count(), 2);
+
+    // The least recently used pixmap is removed.
+    cache->pixmap(icon1, 32, 1.0);
+    const QPixmap pixmap3 = cache->pixmap(icon3, 32, 1.0);
+    QCOMPARE(cache->count(), 2);
+    QCOMPARE(cache->pixmap(icon3, 32, 1.0).cacheKey(), pixmap3.cacheKey());
+    QCOMPARE(cache->count(), 2);
+}
+
+QTEST_MAIN(KItemListIconCacheTest)
+
+#include "kitemlisticoncachetest.moc"
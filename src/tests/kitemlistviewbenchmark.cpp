@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Dolphin contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "benchmarkitemgenerator.h"
+#include "kitemviews/kfileitemlistview.h"
+#include "kitemviews/kfileitemmodel.h"
+#include "kitemviews/kitemlistcontainer.h"
+#include "kitemviews/kitemlistcontroller.h"
+#include "kitemviews/kitemlistselectionmanager.h"
+#include "kitemviews/private/kitemlistkeyboardsearchmanager.h"
+#include "kitemviews/private/kitemlistrubberband.h"
+#include "kitemviews/private/kitemlistsizehintresolver.h"
+#include "kitemviews/private/kitemlistviewlayouter.h"
+
+#include <QGraphicsView>
+#include <QStandardPaths>
+#include <QTest>
+
+Q_DECLARE_METATYPE(KStandardItemListView::ItemLayout)
+
+/**
+ * Benchmarks the parts of the view that depend on the number of items:
+ * the layout, the size hints, the rubberband selection and the keyboard search.
+ * Additionally the time for painting the frames while scrolling is measured.
+ */
+class KItemListViewBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void layout_data();
+    void layout();
+    void iconSizeHints();
+    void rubberBandSelection();
+    void keyboardSearch();
+    void scrollFrames_data();
+    void scrollFrames();
+
+private:
+    void loadItems(int count);
+
+private:
+    KFileItemListView *m_view;
+    KItemListController *m_controller;
+    KFileItemModel *m_model;
+    KItemListContainer *m_container;
+};
+
+void KItemListViewBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    BenchmarkItemGenerator::suppressMessages();
+}
+
+void KItemListViewBenchmark::init()
+{
+    m_model = new KFileItemModel();
+    m_view = new KFileItemListView();
+    m_controller = new KItemListController(m_model, m_view, this);
+    m_container = new KItemListContainer(m_controller);
+    m_controller->setSelectionBehavior(KItemListController::MultiSelection);
+
+    m_container->resize(1000, 800);
+    m_container->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_container));
+}
+
+void KItemListViewBenchmark::cleanup()
+{
+    delete m_container;
+    m_container = nullptr;
+    m_controller = nullptr;
+    m_view = nullptr;
+
+    delete m_model;
+    m_model = nullptr;
+}
+
+void KItemListViewBenchmark::layout_data()
+{
+    QTest::addColumn<KStandardItemListView::ItemLayout>("itemLayout");
+    QTest::addColumn<bool>("groupedSorting");
+
+    QTest::newRow("icons") << KStandardItemListView::IconsLayout << false;
+    QTest::newRow("icons--grouped") << KStandardItemListView::IconsLayout << true;
+    QTest::newRow("compact") << KStandardItemListView::CompactLayout << false;
+    QTest::newRow("details") << KStandardItemListView::DetailsLayout << false;
+    QTest::newRow("details--grouped") << KStandardItemListView::DetailsLayout << true;
+}
+
+void KItemListViewBenchmark::layout()
+{
+    QFETCH(KStandardItemListView::ItemLayout, itemLayout);
+    QFETCH(bool, groupedSorting);
+
+    m_view->setItemLayout(itemLayout);
+    m_model->setGroupedSorting(groupedSorting);
+    loadItems(20000);
+
+    KItemListViewLayouter *layouter = m_view->m_layouter;
+    QBENCHMARK {
+        layouter->markAsDirty();
+        QVERIFY(layouter->maximumScrollOffset() > 0);
+    }
+}
+
+void KItemListViewBenchmark::iconSizeHints()
+{
+    m_view->setItemLayout(KStandardItemListView::IconsLayout);
+    loadItems(20000);
+
+    KItemListSizeHintResolver *sizeHintResolver = m_view->m_sizeHintResolver;
+    QBENCHMARK {
+        sizeHintResolver->clearCache();
+        sizeHintResolver->updateCache();
+    }
+}
+
+void KItemListViewBenchmark::rubberBandSelection()
+{
+    m_view->setItemLayout(KStandardItemListView::DetailsLayout);
+    loadItems(20000);
+
+    // Drag a rubberband across the visible items
+    KItemListRubberBand *rubberBand = m_view->rubberBand();
+    connect(rubberBand, &KItemListRubberBand::endPositionChanged, m_controller, &KItemListController::slotRubberBandChanged);
+
+    const QSizeF size = m_view->size();
+    QBENCHMARK {
+        rubberBand->setStartPosition(QPointF(1, 1));
+        rubberBand->setEndPosition(QPointF(1, 1));
+        rubberBand->setActive(true);
+        for (qreal y = 1; y < size.height(); y += 4) {
+            rubberBand->setEndPosition(QPointF(size.width() - 1, y));
+        }
+        rubberBand->setActive(false);
+    }
+
+    QVERIFY(m_controller->selectionManager()->hasSelection());
+}
+
+void KItemListViewBenchmark::keyboardSearch()
+{
+    loadItems(20000);
+
+    // Searching for prefixes that only match items near the end of the
+    // list is the worst case, as the items are searched one by one.
+    const QString keys = QStringLiteral("Track 9");
+    KItemListKeyboardSearchManager *keyboardManager = m_controller->m_keyboardManager;
+    QBENCHMARK {
+        keyboardManager->cancelSearch();
+        for (const QChar key : keys) {
+            keyboardManager->addKeys(key);
+        }
+    }
+
+    QVERIFY(m_controller->selectionManager()->currentItem() >= 0);
+}
+
+void KItemListViewBenchmark::scrollFrames_data()
+{
+    QTest::addColumn<KStandardItemListView::ItemLayout>("itemLayout");
+    QTest::addColumn<bool>("itemCacheEnabled");
+
+    QTest::newRow("icons") << KStandardItemListView::IconsLayout << false;
+    QTest::newRow("icons--cached") << KStandardItemListView::IconsLayout << true;
+    QTest::newRow("details") << KStandardItemListView::DetailsLayout << false;
+    QTest::newRow("details--cached") << KStandardItemListView::DetailsLayout << true;
+}
+
+void KItemListViewBenchmark::scrollFrames()
+{
+    QFETCH(KStandardItemListView::ItemLayout, itemLayout);
+    QFETCH(bool, itemCacheEnabled);
+
+    m_view->setItemLayout(itemLayout);
+    m_view->setItemCacheEnabled(itemCacheEnabled);
+    loadItems(20000);
+
+    // Scroll by a few pixels per frame like the smooth scroller does and
+    // paint each frame synchronously. The result is the time for 100 frames.
+    QWidget *viewport = static_cast<QGraphicsView *>(m_container->viewport())->viewport();
+    qreal offset = 0;
+    QBENCHMARK {
+        for (int frame = 0; frame < 100; ++frame) {
+            offset += 7;
+            if (offset > m_view->maximumScrollOffset()) {
+                offset = 0;
+            }
+            m_view->setScrollOffset(offset);
+            viewport->repaint();
+        }
+    }
+
+    QVERIFY(m_view->maximumScrollOffset() > 0);
+}
+
+void KItemListViewBenchmark::loadItems(int count)
+{
+    BenchmarkItemGenerator generator;
+    m_model->slotItemsAdded(m_model->directory(), generator.naturalSortItems(QUrl::fromLocalFile(QStringLiteral("/benchmark")), count));
+    m_model->slotCompleted();
+    QCOMPARE(m_model->count(), count);
+}
+
+QTEST_MAIN(KItemListViewBenchmark)
+
+#include "kitemlistviewbenchmark.moc"
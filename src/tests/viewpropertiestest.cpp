@@ -42,6 +42,7 @@ private Q_SLOTS:
     void testRemotePropsPerFolder();
     void testLocalFallbackMigration();
     void testSymlinkSharesProperties();
+    void testDelayedSaving();
 
 private:
     bool m_globalViewProps;
@@ -740,6 +741,46 @@ void ViewPropertiesTest::testSymlinkSharesProperties()
     }
 }
 
+void ViewPropertiesTest::testDelayedSaving()
+{
+    const QString localFolder = m_testDir->url().toLocalFile();
+    KFileMetaData::UserMetaData metadata(localFolder);
+    if (!metadata.isSupported()) {
+        QSKIP("Delayed saving requires extended attributes");
+    }
+
+    ViewProperties::setDelayedSavingEnabled(true);
+    auto disableDelayedSaving = qScopeGuard([] {
+        ViewProperties::setDelayedSavingEnabled(false);
+    });
+
+    {
+        ViewProperties props(m_testDir->url());
+        props.setSortRole("someNewSortRole");
+    }
+    {
+        ViewProperties props(m_testDir->url());
+        QCOMPARE(props.sortRole(), "someNewSortRole");
+        props.setViewMode(DolphinView::CompactView);
+    }
+
+    // The changes are pending, but are already visible when reading the properties.
+    QVERIFY(!metadata.hasAttribute(QStringLiteral("kde.fm.viewproperties#1")));
+    {
+        ViewProperties props(m_testDir->url());
+        QCOMPARE(props.sortRole(), "someNewSortRole");
+        QCOMPARE(props.viewMode(), DolphinView::CompactView);
+    }
+
+    ViewProperties::savePendingChanges();
+    QVERIFY(metadata.hasAttribute(QStringLiteral("kde.fm.viewproperties#1")));
+    QVERIFY(!QFile::exists(localFolder + "/.directory"));
+
+    ViewProperties props(m_testDir->url());
+    QCOMPARE(props.sortRole(), "someNewSortRole");
+    QCOMPARE(props.viewMode(), DolphinView::CompactView);
+}
+
 QTEST_GUILESS_MAIN(ViewPropertiesTest)
 
 #include "viewpropertiestest.moc"
@@ -21,6 +21,7 @@
 #include "kitemviews/kitemlistcontroller.h"
 #include "kitemviews/kitemlistheader.h"
 #include "kitemviews/kitemlistselectionmanager.h"
+#include "kitemviews/private/kitemlisticoncache.h"
 #include "kitemviews/private/kitemlistroleeditor.h"
 #include "selectionmode/singleclickselectionproxystyle.h"
 #include "settings/viewmodes/viewmodesettings.h"
@@ -74,9 +75,10 @@
 #include <QSize>
 #include <QTimer>
 #include <QToolTip>
+#include <QUrlQuery>
 #include <QVBoxLayout>
 
-DolphinView::DolphinView(const QUrl &url, QWidget *parent)
+DolphinView::DolphinView(const QUrl &url, QWidget *parent, bool loadingDeferred)
     : QWidget(parent)
     , m_active(true)
     , m_tabsForFiles(false)
@@ -97,6 +99,10 @@ DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     , m_currentItemUrl()
     , m_scrollToCurrentItem(false)
     , m_restoredContentsPosition()
+    , m_loadingDeferred(loadingDeferred)
+    , m_deferredLoadingPending(false)
+    , m_viewPropertiesPending(false)
+    , m_deferredExpandedUrls()
     , m_controlWheelAccumulatedDelta(0)
     , m_selectedUrls()
     , m_clearSelectionBeforeSelectingNewItems(false)
@@ -221,6 +227,7 @@ DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     connect(m_model, &KFileItemModel::directoryLoadingCanceled, this, &DolphinView::slotDirectoryLoadingCanceled);
     connect(m_model, &KFileItemModel::directoryLoadingProgress, this, &DolphinView::directoryLoadingProgress);
     connect(m_model, &KFileItemModel::directorySortingProgress, this, &DolphinView::directorySortingProgress);
+    connect(m_model, &KFileItemModel::subtreeExpansionProgress, this, &DolphinView::subtreeExpansionProgress);
     connect(m_model, &KFileItemModel::itemsChanged, this, &DolphinView::slotItemsChanged);
     connect(m_model, &KFileItemModel::itemsRemoved, this, &DolphinView::itemCountChanged);
     connect(m_model, &KFileItemModel::itemsInserted, this, &DolphinView::itemCountChanged);
@@ -1086,6 +1093,7 @@ bool DolphinView::eventFilter(QObject *watched, QEvent *event)
     case QEvent::PaletteChange:
         updatePalette();
         QPixmapCache::clear();
+        KItemListIconCache::instance()->clear();
         break;
 
     case QEvent::WindowActivate:
@@ -1775,12 +1783,24 @@ void DolphinView::restoreState(QDataStream &stream)
     QSet<QUrl> urls;
     stream >> urls;
     m_model->restoreExpandedDirectories(urls);
+    if (m_loadingDeferred) {
+        m_deferredExpandedUrls = urls;
+    }
 }
 
 void DolphinView::saveState(QDataStream &stream)
 {
     stream << quint32(1); // View state version
 
+    if (m_loadingDeferred) {
+        // The directory has not been loaded yet, so the restored state is still valid
+        stream << m_currentItemUrl;
+        stream << m_selectedUrls;
+        stream << m_restoredContentsPosition;
+        stream << m_deferredExpandedUrls;
+        return;
+    }
+
     // Save the current item that has the keyboard focus
     const int currentIndex = m_container->controller()->selectionManager()->currentItem();
     if (currentIndex != -1) {
@@ -1804,6 +1824,35 @@ void DolphinView::saveState(QDataStream &stream)
     stream << m_model->expandedDirectories();
 }
 
+void DolphinView::setLoadingDeferred(bool deferred)
+{
+    if (m_loadingDeferred == deferred) {
+        return;
+    }
+
+    m_loadingDeferred = deferred;
+    if (deferred) {
+        m_model->cancelDirectoryLoading();
+        m_model->clear();
+        m_deferredLoadingPending = true;
+    } else {
+        m_deferredExpandedUrls.clear();
+        if (m_viewPropertiesPending) {
+            m_viewPropertiesPending = false;
+            applyViewProperties();
+        }
+        if (m_deferredLoadingPending) {
+            m_deferredLoadingPending = false;
+            loadDirectory(m_url);
+        }
+    }
+}
+
+bool DolphinView::isLoadingDeferred() const
+{
+    return m_loadingDeferred;
+}
+
 KFileItem DolphinView::rootItem() const
 {
     return m_model->rootItem();
@@ -2388,6 +2437,11 @@ void DolphinView::slotRoleEditingFinished(int index, const QByteArray &role, con
 
 void DolphinView::loadDirectory(const QUrl &url, bool reload)
 {
+    if (m_loadingDeferred) {
+        m_deferredLoadingPending = true;
+        return;
+    }
+
     if (!url.isValid()) {
         const QString location(url.toDisplayString(QUrl::PreferLocalFile));
         if (location.isEmpty()) {
@@ -2398,6 +2452,13 @@ void DolphinView::loadDirectory(const QUrl &url, bool reload)
         return;
     }
 
+    // The results of a filename search are shown in the order of their arrival until the search has been completed.
+    QString searchTerm;
+    if (url.scheme() == QLatin1String("filenamesearch")) {
+        searchTerm = QUrlQuery(url).queryItemValue(QStringLiteral("search"), QUrl::FullyDecoded);
+    }
+    m_model->setSearchTerm(searchTerm);
+
     if (reload) {
         m_model->refreshDirectory(url);
     } else {
@@ -2407,6 +2468,13 @@ void DolphinView::loadDirectory(const QUrl &url, bool reload)
 
 void DolphinView::applyViewProperties()
 {
+    if (m_loadingDeferred) {
+        // Reading the view properties accesses the directory, which might be
+        // on a slow network mount, so it is postponed like the loading.
+        m_viewPropertiesPending = true;
+        return;
+    }
+
     const ViewProperties props(viewPropertiesUrl());
     applyViewProperties(props);
 }
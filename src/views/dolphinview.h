@@ -85,8 +85,10 @@ public:
     /**
      * @param url              Specifies the content which should be shown.
      * @param parent           Parent widget of the view.
+     * @param loadingDeferred  If true, the directory is not loaded until
+     *                         loading gets enabled by setLoadingDeferred().
      */
-    DolphinView(const QUrl &url, QWidget *parent);
+    DolphinView(const QUrl &url, QWidget *parent, bool loadingDeferred = false);
 
     ~DolphinView() override;
 
@@ -347,6 +349,16 @@ public:
      */
     void saveState(QDataStream &stream);
 
+    /**
+     * If set to true, the directory is not loaded until loading gets enabled
+     * again. Changing the URL only remembers the URL, and the restored view
+     * state is kept until the directory is loaded. Items that have already
+     * been loaded are cleared. The view properties are not read before
+     * the directory gets loaded. Per default loading is not deferred.
+     */
+    void setLoadingDeferred(bool deferred);
+    bool isLoadingDeferred() const;
+
     /**
      * Returns the root item which represents the current URL.
      */
@@ -688,6 +700,12 @@ Q_SIGNALS:
      */
     void directorySortingProgress(int percent);
 
+    /**
+     * Is emitted while all sub-folders of a folder are expanded
+     * and provides the progress information of the expanding.
+     */
+    void subtreeExpansionProgress(int percent);
+
     /**
      * Emitted when the file-item-model emits redirection.
      * Testcase: fish://localhost
@@ -937,6 +955,8 @@ private:
      * to the DolphinView properties. The view properties are read from a
      * .directory file either in the current directory, or in the
      * share/apps/dolphin/view_properties/ subfolder of the user's .kde folder.
+     * If loading is deferred, the view properties are applied when loading
+     * gets enabled again.
      */
     void applyViewProperties();
 
@@ -1059,6 +1079,11 @@ private:
     bool m_scrollToCurrentItem; // Used for marking we need to scroll to current item or not
     QPoint m_restoredContentsPosition;
 
+    bool m_loadingDeferred;
+    bool m_deferredLoadingPending;
+    bool m_viewPropertiesPending; // View properties to apply when loading is not deferred anymore
+    QSet<QUrl> m_deferredExpandedUrls; // Restored expanded folders while loading is deferred
+
     // Used for tracking the accumulated scroll amount (for zooming with high
     // resolution scroll wheels)
     int m_controlWheelAccumulatedDelta;
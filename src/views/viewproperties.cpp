@@ -12,7 +12,10 @@
 #include "dolphindebug.h"
 
 #include <QBuffer>
+#include <QCache>
+#include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QTimer>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -21,6 +24,9 @@
 #include <KFileItem>
 #include <KFileMetaData/UserMetaData>
 
+#include <map>
+#include <memory>
+
 namespace
 {
 const int AdditionalInfoViewPropertiesVersion = 1;
@@ -37,10 +43,174 @@ const char CustomizedDetailsString[] = "CustomizedDetails";
 
 // Filename that is used for storing the properties
 const char ViewPropertiesFileName[] = ".directory";
+
+// Maximum number of directories for which the resolved storage location
+// and the loaded properties are cached
+const int CacheSize = 200;
+
+// Directories that have been changed within this interval (in milliseconds)
+// are not cached: A further change within the granularity of the file system
+// timestamps would not be detected.
+const qint64 RacyChangeInterval = 2000;
+
+// Delay (in milliseconds) for writing changed properties, see
+// ViewProperties::setDelayedSavingEnabled()
+const int SaveDelay = 1000;
+
+struct CachedLocation {
+    QString filePath;
+    qint64 changeTime;
+};
+
+struct CachedProperties {
+    enum Content {
+        // Only the support for extended attributes is cached, the properties
+        // are read from the .directory file each time.
+        Uncached,
+        NoProperties,
+        AttributeProperties
+    };
+
+    bool metaDataSupported;
+    Content content;
+    QString attribute;
+    qint64 changeTime;
+};
+
+struct PendingProperties {
+    std::unique_ptr<ViewPropertySettings> node;
+    // Status change time of the directory when the properties have been
+    // changed, or -1 if the properties are stored in the view-properties directory.
+    qint64 changeTime;
+};
+
+bool s_delayedSaving = false;
+
+QCache<QString, CachedLocation> &locationCache()
+{
+    static QCache<QString, CachedLocation> cache(CacheSize);
+    return cache;
+}
+
+QCache<QString, CachedProperties> &propertiesCache()
+{
+    static QCache<QString, CachedProperties> cache(CacheSize);
+    return cache;
+}
+
+// Changed properties that have not been written yet, see ViewProperties::scheduleSave()
+std::map<QString, PendingProperties> &pendingProperties()
+{
+    static std::map<QString, PendingProperties> properties;
+    return properties;
+}
+
+QTimer *saveTimer()
+{
+    static QTimer *timer = nullptr;
+    if (!timer) {
+        timer = new QTimer(QCoreApplication::instance());
+        timer->setSingleShot(true);
+        timer->setInterval(SaveDelay);
+        QObject::connect(timer, &QTimer::timeout, &ViewProperties::savePendingChanges);
+    }
+    return timer;
+}
+
+/**
+ * @return Time of the last status change of \a path in milliseconds since the
+ *         epoch, or -1 if \a path does not exist. The status of a directory
+ *         changes when entries are added, removed or renamed, and when its
+ *         extended attributes or permissions change.
+ */
+qint64 changeTime(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.metadataChangeTime().toMSecsSinceEpoch() : -1;
+}
+
+bool isCacheable(qint64 changeTime)
+{
+    return changeTime >= 0 && QDateTime::currentMSecsSinceEpoch() - changeTime >= RacyChangeInterval;
+}
+
+void cacheProperties(const QString &folderPath, qint64 folderChangeTime, bool metaDataSupported, CachedProperties::Content content, const QString &attribute = QString())
+{
+    if (isCacheable(folderChangeTime)) {
+        propertiesCache().insert(folderPath, new CachedProperties{metaDataSupported, content, attribute, folderChangeTime});
+    } else {
+        propertiesCache().remove(folderPath);
+    }
+}
+
+ViewPropertySettings *settingsFromAttribute(const QString &viewPropertiesString)
+{
+    auto buffer = std::make_shared<QBuffer>();
+    buffer->setData(viewPropertiesString.toUtf8());
+    // must have the iodevice opened for KConfig
+    if (!buffer->open(QIODevice::ReadWrite)) {
+        qCWarning(DolphinDebug) << "Could not open buffer";
+    }
+
+    auto bufferConfig = std::make_unique<KConfig>(buffer, KConfig::OpenFlag::SimpleConfig);
+
+    return new ViewPropertySettings(std::move(bufferConfig));
+}
+
+/**
+ * Lets \a settings use a buffer instead of the file they have been loaded from,
+ * so that saving them does not touch the file.
+ */
+void detachFromFile(ViewPropertySettings *settings)
+{
+    auto buffer = std::make_shared<QBuffer>();
+    if (!buffer->open(QIODevice::ReadWrite)) {
+        qCWarning(DolphinDebug) << "Could not create buffer";
+    }
+    auto config = std::make_unique<KConfig>(buffer, KConfig::OpenFlag::SimpleConfig);
+    config->copyFrom(*settings->config());
+    settings->setConfig(std::move(config));
+    settings->save();
+}
+
+ViewPropertySettings *copyOfSettings(ViewPropertySettings *settings)
+{
+    auto buffer = std::make_shared<QBuffer>();
+    if (!buffer->open(QIODevice::ReadWrite)) {
+        qCWarning(DolphinDebug) << "Could not create buffer";
+    }
+    auto config = std::make_unique<KConfig>(buffer, KConfig::OpenFlag::SimpleConfig);
+    config->copyFrom(*settings->config());
+    return new ViewPropertySettings(std::move(config));
+}
 }
 
-ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath) const
+ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath, bool *metaDataSupported) const
 {
+    const auto &pending = pendingProperties();
+    if (const auto it = pending.find(folderPath); it != pending.end()) {
+        if (metaDataSupported) {
+            *metaDataSupported = true;
+        }
+        return copyOfSettings(it->second.node.get());
+    }
+
+    // Reading the properties requires several accesses to the file system, which
+    // is done each time a view property is changed. Cache the properties as long
+    // as the directory has not been changed.
+    const qint64 folderChangeTime = changeTime(folderPath);
+    const CachedProperties *cached = propertiesCache().object(folderPath);
+    if (cached && cached->changeTime == folderChangeTime) {
+        if (metaDataSupported) {
+            *metaDataSupported = cached->metaDataSupported;
+        }
+        if (cached->content == CachedProperties::NoProperties) {
+            return nullptr;
+        } else if (cached->content == CachedProperties::AttributeProperties) {
+            return settingsFromAttribute(cached->attribute);
+        }
+    }
+
     const QString settingsFile = folderPath + QDir::separator() + ViewPropertiesFileName;
 
     std::shared_ptr<QFile> file = std::make_shared<QFile>(settingsFile);
@@ -52,7 +222,11 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
     }
 
     KFileMetaData::UserMetaData metadata(folderPath);
+    if (metaDataSupported) {
+        *metaDataSupported = metadata.isSupported();
+    }
     if (!metadata.isSupported()) {
+        cacheProperties(folderPath, folderChangeTime, false, CachedProperties::Uncached);
         auto fileConfig = std::make_unique<KConfig>(file, KConfig::OpenFlag::SimpleConfig);
         return new ViewPropertySettings(std::move(fileConfig));
     }
@@ -78,6 +252,7 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
 
             auto bufferConfig = std::make_unique<KConfig>(buffer, KConfig::OpenFlag::SimpleConfig);
             bufferConfig->copyFrom(config);
+            cacheProperties(folderPath, folderChangeTime, true, CachedProperties::Uncached);
             return new ViewPropertySettings(std::move(bufferConfig));
         }
     }
@@ -85,18 +260,12 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
     // load from metadata
     const QString viewPropertiesString = metadata.attribute(MetaDataKey);
     if (viewPropertiesString.isEmpty()) {
+        cacheProperties(folderPath, folderChangeTime, true, CachedProperties::NoProperties);
         return nullptr;
     }
 
-    buffer->setData(viewPropertiesString.toUtf8());
-    // must have the iodevice opened for KConfig
-    if (!buffer->open(QIODevice::ReadWrite)) {
-        qCWarning(DolphinDebug) << "Could not open buffer";
-    }
-
-    auto bufferConfig = std::make_unique<KConfig>(buffer, KConfig::OpenFlag::SimpleConfig);
-
-    return new ViewPropertySettings(std::move(bufferConfig));
+    cacheProperties(folderPath, folderChangeTime, true, CachedProperties::AttributeProperties, viewPropertiesString);
+    return settingsFromAttribute(viewPropertiesString);
 }
 
 ViewPropertySettings *ViewProperties::defaultProperties() const
@@ -152,6 +321,7 @@ bool ViewProperties::isDefaults() const
 ViewProperties::ViewProperties(const QUrl &url)
     : m_changedProps(false)
     , m_autoSave(true)
+    , m_metaDataSupported(false)
     , m_node(nullptr)
 {
     GeneralSettings *settings = GeneralSettings::self();
@@ -179,53 +349,18 @@ ViewProperties::ViewProperties(const QUrl &url)
     } else if (useGlobalViewProps) {
         m_filePath = destinationDir(QStringLiteral("global"));
     } else if (url.isLocalFile()) {
-        m_filePath = url.toLocalFile();
-        const QString localPath = m_filePath;
-
-        // Resolve symlinks (bug 477662).
-        const QFileInfo dirInfo(m_filePath);
-        if (const QString canonicalPath = dirInfo.canonicalFilePath(); !canonicalPath.isEmpty()) {
-            m_filePath = canonicalPath;
-        }
-        const QUrl canonicalUrl = QUrl::fromLocalFile(m_filePath);
-
-        bool useDestinationDir = !isPartOfHome(m_filePath);
-        if (!useDestinationDir) {
-            const KFileItem fileItem(canonicalUrl);
-            useDestinationDir = fileItem.isSlow();
-        }
-
-        if (!useDestinationDir) {
-            const QFileInfo fileInfo(m_filePath + QDir::separator() + ViewPropertiesFileName);
-            bool dirWritable = dirInfo.isWritable();
-#ifdef Q_OS_WIN
-            if (dirWritable) {
-                const DWORD attrs = GetFileAttributesW(reinterpret_cast<const wchar_t *>(m_filePath.utf16()));
-                dirWritable = (attrs == INVALID_FILE_ATTRIBUTES) || !(attrs & FILE_ATTRIBUTE_READONLY);
-            }
-#endif
-            useDestinationDir = !dirWritable || (dirInfo.size() > 0 && fileInfo.exists() && !(fileInfo.isReadable() && fileInfo.isWritable()));
-        }
-
-        if (useDestinationDir) {
-            m_filePath = destinationDir(QStringLiteral("local/")) + directoryHashForUrl(canonicalUrl);
-
-            // Migration: properties for such folders used to be stored under the
-            // full local path, which could exceed path-length limits and exposed
-            // the path in the storage location. Move an existing entry to the
-            // hashed location once.
-            // TODO: remove this block after 2028-06, once Debian 14 (Forky)
-            // has shipped and users have had time to migrate.
-            if (!QFileInfo::exists(m_filePath)) {
-#ifdef Q_OS_WIN
-                // The old path had the drive colon stripped to keep it valid.
-                const QString oldPath = destinationDir(QStringLiteral("local")) + QDir::separator() + QString(localPath).remove(QLatin1Char(':'));
-#else
-                const QString oldPath = destinationDir(QStringLiteral("local")) + localPath;
-#endif
-                if (QFileInfo::exists(oldPath)) {
-                    QDir().rename(oldPath, m_filePath);
-                }
+        const QString localPath = url.toLocalFile();
+
+        // Resolving the storage location requires several accesses to the file system.
+        // Cache it as long as the directory has not been changed.
+        const qint64 localPathChangeTime = changeTime(localPath);
+        const CachedLocation *cachedLocation = locationCache().object(localPath);
+        if (cachedLocation && cachedLocation->changeTime == localPathChangeTime) {
+            m_filePath = cachedLocation->filePath;
+        } else {
+            m_filePath = resolveLocalFilePath(localPath);
+            if (isCacheable(localPathChangeTime)) {
+                locationCache().insert(localPath, new CachedLocation{m_filePath, localPathChangeTime});
             }
         }
 
@@ -236,7 +371,7 @@ ViewProperties::ViewProperties(const QUrl &url)
         m_filePath = destinationDir(QStringLiteral("remote/")) + directoryHashForUrl(url);
     }
 
-    auto propsOpt = loadProperties(m_filePath);
+    auto propsOpt = loadProperties(m_filePath, &m_metaDataSupported);
 
     bool useDefaultSettings =
         // If the props timestamp is too old,
@@ -319,22 +454,130 @@ ViewProperties::ViewProperties(const QUrl &url)
     }
 }
 
+QString ViewProperties::resolveLocalFilePath(const QString &localPath) const
+{
+    QString filePath = localPath;
+
+    // Resolve symlinks (bug 477662).
+    const QFileInfo dirInfo(filePath);
+    if (const QString canonicalPath = dirInfo.canonicalFilePath(); !canonicalPath.isEmpty()) {
+        filePath = canonicalPath;
+    }
+    const QUrl canonicalUrl = QUrl::fromLocalFile(filePath);
+
+    bool useDestinationDir = !isPartOfHome(filePath);
+    if (!useDestinationDir) {
+        const KFileItem fileItem(canonicalUrl);
+        useDestinationDir = fileItem.isSlow();
+    }
+
+    if (!useDestinationDir) {
+        const QFileInfo fileInfo(filePath + QDir::separator() + ViewPropertiesFileName);
+        bool dirWritable = dirInfo.isWritable();
+#ifdef Q_OS_WIN
+        if (dirWritable) {
+            const DWORD attrs = GetFileAttributesW(reinterpret_cast<const wchar_t *>(filePath.utf16()));
+            dirWritable = (attrs == INVALID_FILE_ATTRIBUTES) || !(attrs & FILE_ATTRIBUTE_READONLY);
+        }
+#endif
+        useDestinationDir = !dirWritable || (dirInfo.size() > 0 && fileInfo.exists() && !(fileInfo.isReadable() && fileInfo.isWritable()));
+    }
+
+    if (useDestinationDir) {
+        filePath = destinationDir(QStringLiteral("local/")) + directoryHashForUrl(canonicalUrl);
+
+        // Migration: properties for such folders used to be stored under the
+        // full local path, which could exceed path-length limits and exposed
+        // the path in the storage location. Move an existing entry to the
+        // hashed location once.
+        // TODO: remove this block after 2028-06, once Debian 14 (Forky)
+        // has shipped and users have had time to migrate.
+        if (!QFileInfo::exists(filePath)) {
+#ifdef Q_OS_WIN
+            // The old path had the drive colon stripped to keep it valid.
+            const QString oldPath = destinationDir(QStringLiteral("local")) + QDir::separator() + QString(localPath).remove(QLatin1Char(':'));
+#else
+            const QString oldPath = destinationDir(QStringLiteral("local")) + localPath;
+#endif
+            if (QFileInfo::exists(oldPath)) {
+                QDir().rename(oldPath, filePath);
+            }
+        }
+    }
+
+    return filePath;
+}
+
+ViewProperties::ViewProperties(const QString &filePath, ViewPropertySettings *node)
+    : m_changedProps(false)
+    , m_autoSave(false)
+    , m_metaDataSupported(true)
+    , m_filePath(filePath)
+    , m_node(node)
+{
+}
+
 ViewProperties::~ViewProperties()
 {
+    QString name;
     if (m_changedProps && m_autoSave) {
-        save();
+        if (s_delayedSaving && m_metaDataSupported) {
+            // The pending properties don't use the backing file anymore
+            name = m_node->config()->name();
+            scheduleSave();
+        } else {
+            save();
+        }
     }
 
-    auto name = m_node->config()->name();
+    if (m_node) {
+        name = m_node->config()->name();
+    }
     if (!name.isEmpty() && !name.endsWith(ViewPropertiesFileName)) {
         // remove backing file
-        QFile::remove(m_node->config()->name());
+        QFile::remove(name);
     }
 
     delete m_node;
     m_node = nullptr;
 }
 
+void ViewProperties::setDelayedSavingEnabled(bool enabled)
+{
+    if (s_delayedSaving == enabled) {
+        return;
+    }
+
+    s_delayedSaving = enabled;
+    if (enabled) {
+        static bool savedOnQuit = false;
+        if (!savedOnQuit) {
+            QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, &ViewProperties::savePendingChanges);
+            savedOnQuit = true;
+        }
+    } else {
+        savePendingChanges();
+    }
+}
+
+void ViewProperties::savePendingChanges()
+{
+    saveTimer()->stop();
+
+    auto pending = std::move(pendingProperties());
+    pendingProperties().clear();
+    for (auto &[filePath, properties] : pending) {
+        if (properties.changeTime != -1 && changeTime(filePath) != properties.changeTime) {
+            // The directory has been removed, renamed or replaced since
+            // the properties have been changed.
+            qCDebug(DolphinDebug) << "Dropping pending view-properties of changed directory" << filePath;
+            continue;
+        }
+        ViewProperties props(filePath, properties.node.release());
+        props.save();
+    }
+}
+
 void ViewProperties::setZoomLevel(int zoomLevel)
 {
     if (m_node->zoomLevel() != zoomLevel) {
@@ -609,10 +852,30 @@ void ViewProperties::update()
     m_node->setTimestamp(QDateTime::currentDateTime());
 }
 
+void ViewProperties::scheduleSave()
+{
+    // The properties might have been loaded from a file that gets removed
+    // or that belongs to another directory.
+    detachFromFile(m_node);
+    m_node->setVersion(CurrentViewPropertiesVersion);
+
+    propertiesCache().remove(m_filePath);
+    PendingProperties &pending = pendingProperties()[m_filePath];
+    pending.node.reset(m_node);
+    pending.changeTime = isInViewPropertiesDir() ? -1 : changeTime(m_filePath);
+    m_node = nullptr;
+
+    saveTimer()->start();
+}
+
 void ViewProperties::save()
 {
     qCDebug(DolphinDebug) << "Saving view-properties to" << m_filePath;
 
+    // The properties saved now replace the pending ones and the cached ones.
+    pendingProperties().erase(m_filePath);
+    propertiesCache().remove(m_filePath);
+
     auto cleanDotDirectoryFile = [this]() {
         const QString settingsFile = m_filePath + QDir::separator() + ViewPropertiesFileName;
         if (QFile::exists(settingsFile)) {
@@ -632,17 +895,23 @@ void ViewProperties::save()
         }
     };
 
-    // ensures the destination dir exists, in case we don't write metadata directly on the folder
+    // ensures the destination dir exists, in case we don't write metadata directly on the folder.
+    // The folder itself is never created, as it might have been removed or renamed in the meantime.
     QDir destinationDir(m_filePath);
-    if (!destinationDir.exists() && !destinationDir.mkpath(m_filePath)) {
-        qCWarning(DolphinDebug) << "Could not create fake directory to store metadata";
+    if (!destinationDir.exists()) {
+        if (!isInViewPropertiesDir()) {
+            qCDebug(DolphinDebug) << "Not saving view-properties of removed directory" << m_filePath;
+            m_changedProps = false;
+            return;
+        }
+        if (!destinationDir.mkpath(m_filePath)) {
+            qCWarning(DolphinDebug) << "Could not create fake directory to store metadata";
+        }
     }
 
     KFileMetaData::UserMetaData metaData(m_filePath);
     if (!metaData.isSupported()) {
         // save to dotDirectory file as fallback
-        QDir dir;
-        dir.mkpath(m_filePath);
         m_node->setVersion(CurrentViewPropertiesVersion);
         m_node->save();
 
@@ -748,6 +1017,11 @@ QString ViewProperties::destinationDir(const QString &subDir) const
     return path;
 }
 
+bool ViewProperties::isInViewPropertiesDir() const
+{
+    return m_filePath.startsWith(destinationDir(QString()));
+}
+
 QString ViewProperties::viewModePrefix() const
 {
     QString prefix;
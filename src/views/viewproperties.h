@@ -141,7 +141,49 @@ public:
     void restoreToDefaults();
     bool isDefaults() const;
 
+    /**
+     * If enabled, changed properties are not written when the ViewProperties
+     * instance gets destructed, but with a small delay. Subsequent changes of
+     * the same directory are written at once. Reading the properties returns
+     * the changed values also before they have been written. Only properties
+     * stored as extended attributes are delayed.
+     *
+     * The pending changes are written when the application quits or when
+     * disabling the delayed saving. Disabled per default.
+     */
+    static void setDelayedSavingEnabled(bool enabled);
+
+    /**
+     * Writes the changed properties that are pending because of the delayed
+     * saving, see ViewProperties::setDelayedSavingEnabled().
+     */
+    static void savePendingChanges();
+
 private:
+    /**
+     * Creates an instance for writing the pending properties \a node of the
+     * directory \a filePath. Takes ownership of \a node.
+     */
+    ViewProperties(const QString &filePath, ViewPropertySettings *node);
+
+    /**
+     * Passes the properties to the pending changes, which are written with
+     * a small delay.
+     */
+    void scheduleSave();
+
+    /**
+     * @return Path of the directory where the properties of the local
+     *         directory \a localPath are stored.
+     */
+    QString resolveLocalFilePath(const QString &localPath) const;
+
+    /**
+     * @return True if the properties are stored in the view-properties directory
+     *         of Dolphin instead of the directory they belong to.
+     */
+    bool isInViewPropertiesDir() const;
+
     /**
      * Returns the view-mode prefix when storing additional properties for
      * a view-mode.
@@ -173,8 +215,9 @@ private:
      */
     static bool isPartOfHome(const QString &filePath);
 
-    /** @returns a ViewPropertySettings object with properties loaded for the directory at @param filePath. Ownership is returned to the caller. */
-    ViewPropertySettings *loadProperties(const QString &folderPath) const;
+    /** @returns a ViewPropertySettings object with properties loaded for the directory at @param filePath. Ownership is returned to the caller.
+     *  @param metaDataSupported is set to whether extended attributes are supported for the directory. */
+    ViewPropertySettings *loadProperties(const QString &folderPath, bool *metaDataSupported = nullptr) const;
     /** @returns a ViewPropertySettings object with the globally configured default values. Ownership is returned to the caller. */
     ViewPropertySettings *defaultProperties() const;
 
@@ -183,6 +226,7 @@ private:
 private:
     bool m_changedProps;
     bool m_autoSave;
+    bool m_metaDataSupported;
     QString m_filePath;
     ViewPropertySettings *m_node;
 };